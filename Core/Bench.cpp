@@ -0,0 +1,338 @@
+#include "Bench.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Memory.h"
+#include "MoveList.h"
+#include "Nnue.h"
+#include "NnueKernels.h"
+#include "Numa.h"
+#include "SearchThread.h"
+
+namespace
+{
+	const char* BENCH_FENS[] =
+	{
+		"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+	};
+
+	struct SelectivityRun
+	{
+		const char* name;
+		SearchOptions options;
+	};
+
+	SearchOptions Without(bool SearchOptions::*option)
+	{
+		SearchOptions options;
+		options.*option = false;
+		return options;
+	}
+
+	// Too large for the stack; static storage keeps its cache-line alignment
+	AccumulatorStack benchAccumulators;
+	AccumulatorStack refreshAccumulators;
+
+	// Scores of every position one and two moves deep, in a fixed order
+	void EvaluateTree(const Nnue& network, Position& pos, std::vector<int>& scores, bool checkRefresh, int& mismatches)
+	{
+		benchAccumulators.reset(pos, network);
+
+		for (Move move : MoveList(pos))
+		{
+			benchAccumulators.push(pos, move);
+			pos.make(move);
+			scores.push_back(NnueEvaluate(pos, benchAccumulators));
+
+			for (Move reply : MoveList(pos))
+			{
+				benchAccumulators.push(pos, reply);
+				pos.make(reply);
+				scores.push_back(NnueEvaluate(pos, benchAccumulators));
+
+				if (checkRefresh)
+				{
+					refreshAccumulators.reset(pos, network);
+					mismatches += NnueEvaluate(pos, refreshAccumulators) != scores.back();
+				}
+
+				pos.unmake(reply);
+				benchAccumulators.pop();
+			}
+
+			pos.unmake(move);
+			benchAccumulators.pop();
+		}
+	}
+}
+
+void BenchThreads(int maxThreads, int64_t moveTime, size_t hashMegabytes, bool numa, bool hugePages)
+{
+	SearchThread engine;
+	SearchLimits limits = { 0, moveTime, 0 };
+	double baseNps = 0;
+
+	printf("numa nodes %d binding %s huge pages %s\n", NumaNodeCount(), numa ? "on" : "off", hugePages ? "on" : "off");
+
+	engine.setNumaBinding(numa);
+	engine.setHashSize(hashMegabytes, hugePages);
+
+	for (int threads = 1; threads <= maxThreads; threads = threads * 2 > maxThreads && threads < maxThreads ? maxThreads : threads * 2)
+	{
+		uint64_t nodes = 0;
+		int64_t elapsed = 0;
+
+		engine.setThreads(threads);
+
+		for (const char* fen : BENCH_FENS)
+		{
+			Position pos;
+			pos.setFen(fen);
+			engine.clearHash();
+			engine.start(pos, limits);
+
+			SearchInfo info;
+
+			while (!engine.poll(info) || !info.finished)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+
+			nodes += info.result.nodes;
+			elapsed += info.result.elapsed;
+		}
+
+		double nps = elapsed > 0 ? nodes * 1000.0 / elapsed : 0;
+		baseNps = threads == 1 ? nps : baseNps;
+
+		printf("threads %3d nodes %12llu nps %12.0f scaling %5.2fx\n", threads, (unsigned long long)nodes, nps,
+			baseNps > 0 ? nps / baseNps : 0);
+	}
+}
+
+void BenchSelectivity(int depth)
+{
+	SearchOptions none;
+	none.principalVariation = none.aspirationWindows = none.nullMove = none.lateMoveReductions = none.reverseFutility = none.futility = none.lateMovePruning = false;
+
+	const SelectivityRun runs[] =
+	{
+		{ "all on", SearchOptions() },
+		{ "no PVS", Without(&SearchOptions::principalVariation) },
+		{ "no aspiration windows", Without(&SearchOptions::aspirationWindows) },
+		{ "no null move", Without(&SearchOptions::nullMove) },
+		{ "no late move reductions", Without(&SearchOptions::lateMoveReductions) },
+		{ "no reverse futility", Without(&SearchOptions::reverseFutility) },
+		{ "no futility", Without(&SearchOptions::futility) },
+		{ "no late move pruning", Without(&SearchOptions::lateMovePruning) },
+		{ "all off", none }
+	};
+
+	SearchLimits limits = { depth, 0, 0 };
+	TranspositionTable tt;
+	int64_t baseTime = 0;
+	uint64_t baseNodes = 0;
+
+	printf("time to depth %d\n", depth);
+
+	for (const SelectivityRun& run : runs)
+	{
+		// A new search for every run, so no history is carried over from the previous one
+		std::unique_ptr<Search> search(new Search(tt));
+		search->setOptions(run.options);
+
+		uint64_t nodes = 0;
+		int64_t elapsed = 0;
+
+		for (const char* fen : BENCH_FENS)
+		{
+			Position pos;
+			pos.setFen(fen);
+			tt.clear(1);
+
+			SearchResult result = search->think(pos, limits);
+			nodes += result.nodes;
+			elapsed += result.elapsed;
+		}
+
+		baseTime = baseTime ? baseTime : elapsed > 0 ? elapsed : 1;
+		baseNodes = baseNodes ? baseNodes : nodes > 0 ? nodes : 1;
+
+		printf("%-24s nodes %12llu (%6.2fx) time %8lldms (%6.2fx)\n", run.name, (unsigned long long)nodes,
+			(double)nodes / baseNodes, (long long)elapsed, (double)elapsed / baseTime);
+	}
+}
+
+void BenchStats(const Position& pos, int depth, int threads)
+{
+	SearchThread engine;
+	SearchLimits limits = { depth, 0, 0 };
+	SearchInfo info;
+
+	engine.setThreads(threads);
+	engine.start(pos, limits);
+
+	do
+	{
+		while (!engine.poll(info))
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		if (!info.finished)
+		{
+			printf("depth %2d score %6d nodes %10llu time %6lldms %s\n", info.result.depth, info.result.score,
+				(unsigned long long)info.result.nodes, (long long)info.result.elapsed, StatsSummary(info.result).c_str());
+		}
+	} while (!info.finished);
+
+	printf("%s", StatsReport(info.result).c_str());
+}
+
+bool WriteRandomNnue(const std::string& path, unsigned seed)
+{
+	NnueNetwork* net = (NnueNetwork*)AlignedAlloc(64, sizeof(NnueNetwork));
+
+	if (!net)
+	{
+		return false;
+	}
+
+	std::mt19937 rng(seed);
+	// Small enough that no sum overflows its type, large enough that every layer passes something on
+	std::uniform_int_distribution<int> featureWeight(-32, 32);
+	std::uniform_int_distribution<int> weight(-64, 64);
+	std::uniform_int_distribution<int> bias(-2000, 6000);
+
+	memset(net, 0, sizeof(NnueNetwork));
+	memcpy(net->header.magic, NNUE_MAGIC, sizeof(NNUE_MAGIC));
+	net->header.version = NNUE_VERSION;
+	net->header.inputs = NNUE_INPUTS;
+	net->header.hidden = NNUE_HIDDEN;
+	net->header.l1 = NNUE_L1;
+	net->header.l2 = NNUE_L2;
+
+	for (int i = 0; i < NNUE_HIDDEN; i++)
+	{
+		net->featureBiases[i] = (int16_t)(featureWeight(rng) + 32);
+	}
+
+	for (int f = 0; f < NNUE_INPUTS; f++)
+	{
+		for (int i = 0; i < NNUE_HIDDEN; i++)
+		{
+			net->featureWeights[f][i] = (int16_t)featureWeight(rng);
+		}
+	}
+
+	for (int o = 0; o < NNUE_L1; o++)
+	{
+		net->hidden1Biases[o] = bias(rng);
+
+		for (int i = 0; i < 2 * NNUE_HIDDEN; i++)
+		{
+			net->hidden1Weights[o][i] = (int8_t)weight(rng);
+		}
+	}
+
+	for (int o = 0; o < NNUE_L2; o++)
+	{
+		net->hidden2Biases[o] = bias(rng);
+
+		for (int i = 0; i < NNUE_L1; i++)
+		{
+			net->hidden2Weights[o][i] = (int8_t)weight(rng);
+		}
+	}
+
+	net->outputBias = 0;
+
+	for (int i = 0; i < NNUE_L2; i++)
+	{
+		net->outputWeights[i] = (int8_t)weight(rng);
+	}
+
+	FILE* file = fopen(path.c_str(), "wb");
+	bool written = file && fwrite(net, sizeof(NnueNetwork), 1, file) == 1;
+
+	if (file)
+	{
+		written = fclose(file) == 0 && written;
+	}
+
+	AlignedFree(net);
+	return written;
+}
+
+int BenchNnue(const std::string& path)
+{
+	std::shared_ptr<const Nnue> best = LoadNnue(path);
+
+	if (!best)
+	{
+		printf("cannot load network %s\n", path.c_str());
+		return 1;
+	}
+
+	std::vector<int> reference;
+	int mismatches = 0;
+
+	// The same file once more for each kernel set below the best
+	for (int level = SimdScalar; level <= best->kernels().level; level++)
+	{
+		std::shared_ptr<const Nnue> network = level == best->kernels().level ? best : LoadNnue(path, SimdLevel(level));
+		std::vector<int> scores;
+		int levelMismatches = 0;
+
+		auto start = std::chrono::steady_clock::now();
+
+		for (const char* fen : BENCH_FENS)
+		{
+			Position pos;
+			pos.setFen(fen);
+			EvaluateTree(*network, pos, scores, false, levelMismatches);
+		}
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (level == SimdScalar)
+		{
+			reference = scores;
+		}
+
+		for (size_t i = 0; i < scores.size(); i++)
+		{
+			levelMismatches += scores[i] != reference[i];
+		}
+
+		mismatches += levelMismatches;
+
+		printf("%-14s evaluations %9zu evals/s %12.0f mismatches %d\n", SimdLevelName(SimdLevel(level)), scores.size(),
+			seconds > 0 ? scores.size() / seconds : 0, levelMismatches);
+	}
+
+	// The incremental updates against accumulators built from scratch, with the fastest kernels
+	std::vector<int> scores;
+	int refreshMismatches = 0;
+
+	for (const char* fen : BENCH_FENS)
+	{
+		Position pos;
+		pos.setFen(fen);
+		EvaluateTree(*best, pos, scores, true, refreshMismatches);
+	}
+
+	printf("%-14s mismatches %d\n", "full refresh", refreshMismatches);
+
+	return mismatches + refreshMismatches;
+}
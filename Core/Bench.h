@@ -0,0 +1,33 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Position.h"
+
+// Searches a fixed set of positions for moveTime milliseconds each with 1, 2, 4 ... maxThreads
+// threads and prints nodes/second for every thread count, relative to one thread.
+// numa pins the threads to NUMA nodes and hugePages backs the hash with huge pages, see SearchThread.
+void BenchThreads(int maxThreads, int64_t moveTime, size_t hashMegabytes, bool numa = false, bool hugePages = false);
+
+// Searches the same positions to a fixed depth on one thread, first with every search option on,
+// then with each one switched off and with all of them off, and prints the nodes and time to depth
+// of each run against the first.
+void BenchSelectivity(int depth);
+
+// Searches pos to a fixed depth with the given number of threads, printing every iteration with its
+// hit and cutoff rates, then the full statistics of the search.
+void BenchStats(const Position& pos, int depth, int threads);
+
+// Writes a network of random weights in the layout of NnueNetwork, to exercise the loader and kernels
+// while no trained network is available.
+bool WriteRandomNnue(const std::string& path, unsigned seed);
+
+// Loads a network and evaluates every position one and two moves deep from the bench positions, with
+// each kernel set up to the best one the CPU runs. Prints the evaluations per second of each and
+// returns the number of scores that differ from the scalar kernels or from a full refresh.
+int BenchNnue(const std::string& path);
+
+#endif
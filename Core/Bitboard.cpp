@@ -0,0 +1,199 @@
+#include "Bitboard.h"
+
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(HAS_PEXT)
+#include <cpuid.h>
+#endif
+
+bool usePext = false;
+Magic rookMagics[NUM_SQUARES];
+Magic bishopMagics[NUM_SQUARES];
+Bitboard betweenBB[NUM_SQUARES][NUM_SQUARES];
+Bitboard lineBB[NUM_SQUARES][NUM_SQUARES];
+
+namespace
+{
+	// Sum over all squares of 2^(relevant occupancy bits)
+	Bitboard rookTable[0x19000];
+	Bitboard bishopTable[0x1480];
+
+	const int ROOK_DIRECTIONS[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+	const int BISHOP_DIRECTIONS[4][2] = { { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+
+	// Magic numbers found offline by trying sparse random candidates until every occupancy of the
+	// mask maps to a slot without a destructive collision.
+	const Bitboard ROOK_MAGICS[NUM_SQUARES] =
+	{
+		0x0280008814204000ULL, 0x8680200040008210ULL, 0x4100081020010040ULL, 0x0480080010000480ULL,
+		0x0280128018000400ULL, 0x0100010008020400ULL, 0x4880020041000080ULL, 0x01000A8142022900ULL,
+		0x5210800080204000ULL, 0x5099002081044000ULL, 0x652080100C200080ULL, 0x68010008A5900100ULL,
+		0x0840800400800800ULL, 0x0008808004000200ULL, 0x200400482C10116AULL, 0x84048002C1800900ULL,
+		0x4040008000409020ULL, 0x0A50004040002006ULL, 0x0000420012002080ULL, 0x0002420009220010ULL,
+		0x0001010010040800ULL, 0x2080808002000400ULL, 0x0121240010022108ULL, 0x0100520000440881ULL,
+		0x8060800080204001ULL, 0x1090004140002000ULL, 0x024D004100200010ULL, 0x0822002200104009ULL,
+		0x40080080800A0400ULL, 0x0401000900040002ULL, 0x2000880400108201ULL, 0x0200040600084085ULL,
+		0x0100400020800080ULL, 0x0010002006400040ULL, 0x4200200080801000ULL, 0x8048010010100200ULL,
+		0x0201000801000410ULL, 0x2080800400800200ULL, 0x2000300114003208ULL, 0x0100800040800100ULL,
+		0x8310866040008002ULL, 0x1080201000444000ULL, 0x0C100080A0018014ULL, 0x144900201001000CULL,
+		0x6000080004008080ULL, 0x0402002010040400ULL, 0x0111011008040002ULL, 0x9C00A04903820014ULL,
+		0x840A0040B3008200ULL, 0x6009120420844200ULL, 0x8620005004806380ULL, 0x0802700103A00900ULL,
+		0x1180800800040280ULL, 0x0000040002008080ULL, 0x0058020801100400ULL, 0x0001040108904200ULL,
+		0x0000208440120102ULL, 0x1024401203028022ULL, 0x0C04104008220082ULL, 0x0010002004081101ULL,
+		0x0021000208001005ULL, 0x048200901D080442ULL, 0x0104009001080204ULL, 0x00010A840A41210AULL
+	};
+
+	const Bitboard BISHOP_MAGICS[NUM_SQUARES] =
+	{
+		0x0074010401040104ULL, 0x0882100200811108ULL, 0x01088084018A0088ULL, 0x1404040891000840ULL,
+		0x0104042100020110ULL, 0x0042010420200000ULL, 0x3100510420A00006ULL, 0x0004208218200280ULL,
+		0x0444090208361410ULL, 0x1050082184040040ULL, 0x1016880091021002ULL, 0x000044441080C604ULL,
+		0x4280440420001009ULL, 0x3200011048040428ULL, 0x04808311180241A0ULL, 0x0000008400880420ULL,
+		0x0008214042040C22ULL, 0x8020881004014040ULL, 0xE201010802040010ULL, 0x2D08200404001000ULL,
+		0x0014060480A02001ULL, 0x0002000422100260ULL, 0x0120800208010804ULL, 0x0800880024014800ULL,
+		0x0002400008080810ULL, 0x0001102488020804ULL, 0x4004901012002200ULL, 0x5004080000220040ULL,
+		0x0005010010104000ULL, 0xC410010000208801ULL, 0x000408880C06B400ULL, 0x03A0811040240200ULL,
+		0x1901041000202084ULL, 0x5182011080200204ULL, 0x0002004044440100ULL, 0x0001202020080080ULL,
+		0x0041100400008020ULL, 0x4008100042088800ULL, 0x4010010108004444ULL, 0x800901210C520042ULL,
+		0x8011011011004200ULL, 0x0482008208142112ULL, 0x4000840049000801ULL, 0x0060802014400800ULL,
+		0x0000100201600600ULL, 0x0010204880200100ULL, 0x8021010111056200ULL, 0x101000A081000094ULL,
+		0x0840808420201412ULL, 0x0000840A88052100ULL, 0x0D10248048082000ULL, 0x0700220884040200ULL,
+		0x4002084008222500ULL, 0x8002420801010040ULL, 0x02A0081001104022ULL, 0x00A3040404114041ULL,
+		0x8982140904100440ULL, 0x0011821244020870ULL, 0x484180020904A800ULL, 0x01040CC080840444ULL,
+		0x4000020240082224ULL, 0x000048A020120884ULL, 0x1800409004011840ULL, 0x0004610204090200ULL
+	};
+
+	bool CpuHasFastPext()
+	{
+#if defined(HAS_PEXT)
+		int regs[4] = { 0, 0, 0, 0 };
+		char vendor[13] = {};
+
+#if defined(_MSC_VER)
+		__cpuid(regs, 0);
+#else
+		__cpuid(0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+		int maxLeaf = regs[0];
+		memcpy(vendor, &regs[1], 4);
+		memcpy(vendor + 4, &regs[3], 4);
+		memcpy(vendor + 8, &regs[2], 4);
+
+		if (maxLeaf < 7)
+		{
+			return false;
+		}
+
+#if defined(_MSC_VER)
+		__cpuid(regs, 1);
+#else
+		__cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+		int family = (regs[0] >> 8) & 0xF;
+
+		if (family == 0xF)
+		{
+			family += (regs[0] >> 20) & 0xFF;
+		}
+
+#if defined(_MSC_VER)
+		__cpuidex(regs, 7, 0);
+#else
+		__cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+		bool bmi2 = (regs[1] >> 8) & 1;
+
+		// Zen 1 and Zen 2 implement PEXT in microcode, slower than the magic multiplication
+		bool slowPext = strcmp(vendor, "AuthenticAMD") == 0 && family < 0x19;
+
+		return bmi2 && !slowPext;
+#else
+		return false;
+#endif
+	}
+
+	// Reference attack generation, walking each ray until it leaves the board or hits a piece
+	Bitboard SlidingAttacks(const int directions[4][2], int sq, Bitboard occupied)
+	{
+		Bitboard attacks = 0;
+
+		for (int d = 0; d < 4; d++)
+		{
+			int file = FileOf(sq) + directions[d][0];
+			int rank = RankOf(sq) + directions[d][1];
+
+			while (file >= 0 && file < 8 && rank >= 0 && rank < 8)
+			{
+				Bitboard b = SquareBB(MakeSquare(file, rank));
+				attacks |= b;
+
+				if (occupied & b)
+				{
+					break;
+				}
+
+				file += directions[d][0];
+				rank += directions[d][1];
+			}
+		}
+
+		return attacks;
+	}
+
+	void InitMagics(const int directions[4][2], const Bitboard magicNumbers[], Magic magics[], Bitboard table[])
+	{
+		int size = 0;
+
+		for (int sq = 0; sq < NUM_SQUARES; sq++)
+		{
+			Magic& m = magics[sq];
+
+			// Pieces on the board edge never block a ray, so they are left out of the mask
+			Bitboard edges = ((RANK_1_BB | RANK_8_BB) & ~(RANK_1_BB << (8 * RankOf(sq))))
+				| ((FILE_A_BB | FILE_H_BB) & ~(FILE_A_BB << FileOf(sq)));
+
+			m.mask = SlidingAttacks(directions, sq, 0) & ~edges;
+			m.magic = magicNumbers[sq];
+			m.shift = 64 - Popcount(m.mask);
+			m.attacks = sq == 0 ? table : magics[sq - 1].attacks + size;
+
+			// Enumerate every subset of the mask (Carry-Rippler) and store its attack set
+			size = 0;
+			Bitboard b = 0;
+
+			do
+			{
+				m.attacks[m.index(b)] = SlidingAttacks(directions, sq, b);
+				size++;
+				b = (b - m.mask) & m.mask;
+			} while (b);
+		}
+	}
+}
+
+void InitBitboards()
+{
+	usePext = CpuHasFastPext();
+
+	InitMagics(ROOK_DIRECTIONS, ROOK_MAGICS, rookMagics, rookTable);
+	InitMagics(BISHOP_DIRECTIONS, BISHOP_MAGICS, bishopMagics, bishopTable);
+
+	for (int a = 0; a < NUM_SQUARES; a++)
+	{
+		for (int b = 0; b < NUM_SQUARES; b++)
+		{
+			if (a != b && (RookAttacks(a, 0) & SquareBB(b)))
+			{
+				lineBB[a][b] = (RookAttacks(a, 0) & RookAttacks(b, 0)) | SquareBB(a) | SquareBB(b);
+				betweenBB[a][b] = RookAttacks(a, SquareBB(b)) & RookAttacks(b, SquareBB(a));
+			}
+			else if (a != b && (BishopAttacks(a, 0) & SquareBB(b)))
+			{
+				lineBB[a][b] = (BishopAttacks(a, 0) & BishopAttacks(b, 0)) | SquareBB(a) | SquareBB(b);
+				betweenBB[a][b] = BishopAttacks(a, SquareBB(b)) & BishopAttacks(b, SquareBB(a));
+			}
+		}
+	}
+}
@@ -0,0 +1,195 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+
+#include "Color.cpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// PEXT is only available on 64-bit x86. Whether the CPU has it is decided at startup by InitBitboards.
+#if (defined(_MSC_VER) && defined(_WIN64)) || ((defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__))
+#define HAS_PEXT 1
+#include <immintrin.h>
+#endif
+
+// One bit per square. Squares are numbered a1 = 0, b1 = 1 ... h8 = 63.
+typedef uint64_t Bitboard;
+
+constexpr int NUM_SQUARES = 64;
+
+constexpr Bitboard FILE_A_BB = 0x0101010101010101ULL;
+constexpr Bitboard FILE_H_BB = FILE_A_BB << 7;
+constexpr Bitboard RANK_1_BB = 0xFFULL;
+constexpr Bitboard RANK_3_BB = RANK_1_BB << 16;
+constexpr Bitboard RANK_6_BB = RANK_1_BB << 40;
+constexpr Bitboard RANK_8_BB = RANK_1_BB << 56;
+
+constexpr Bitboard SquareBB(int sq) { return 1ULL << sq; }
+constexpr int FileOf(int sq) { return sq & 7; }
+constexpr int RankOf(int sq) { return sq >> 3; }
+constexpr int MakeSquare(int file, int rank) { return rank * 8 + file; }
+
+// Mapping between squares and the tiles of matrixColors[row][col].
+// White starts on rows 6 and 7 with the king on column 3, so the board is the square numbering mirrored.
+constexpr int SquareOf(int row, int col) { return 63 - (row * 8 + col); }
+constexpr int RowOf(int sq) { return (63 - sq) / 8; }
+constexpr int ColOf(int sq) { return (63 - sq) % 8; }
+
+// Attack sets of the leaping pieces, generated by the compiler
+struct SquareTable
+{
+	Bitboard squares[NUM_SQUARES];
+};
+
+constexpr int KNIGHT_JUMPS[8][2] = { { 1, 2 }, { 2, 1 }, { 2, -1 }, { 1, -2 }, { -1, -2 }, { -2, -1 }, { -2, 1 }, { -1, 2 } };
+constexpr int KING_STEPS[8][2] = { { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 } };
+constexpr int WHITE_PAWN_CAPTURES[2][2] = { { -1, 1 }, { 1, 1 } };
+constexpr int BLACK_PAWN_CAPTURES[2][2] = { { -1, -1 }, { 1, -1 } };
+
+// Builds the table of every (file, rank) offset from every square that stays on the board
+constexpr SquareTable MakeLeaperTable(const int(*offsets)[2], int count)
+{
+	SquareTable table = {};
+
+	for (int sq = 0; sq < NUM_SQUARES; sq++)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			int file = FileOf(sq) + offsets[i][0];
+			int rank = RankOf(sq) + offsets[i][1];
+
+			if (file >= 0 && file < 8 && rank >= 0 && rank < 8)
+			{
+				table.squares[sq] |= SquareBB(MakeSquare(file, rank));
+			}
+		}
+	}
+
+	return table;
+}
+
+constexpr SquareTable KNIGHT_ATTACKS = MakeLeaperTable(KNIGHT_JUMPS, 8);
+constexpr SquareTable KING_ATTACKS = MakeLeaperTable(KING_STEPS, 8);
+constexpr SquareTable PAWN_ATTACKS[3] = { {}, MakeLeaperTable(BLACK_PAWN_CAPTURES, 2), MakeLeaperTable(WHITE_PAWN_CAPTURES, 2) }; // indexed by Color
+
+static_assert(KNIGHT_ATTACKS.squares[0] == 0x20400ULL, "knight table must be built at compile time");
+
+constexpr Bitboard KnightAttacks(int sq) { return KNIGHT_ATTACKS.squares[sq]; }
+constexpr Bitboard KingAttacks(int sq) { return KING_ATTACKS.squares[sq]; }
+constexpr Bitboard PawnAttacks(Color color, int sq) { return PAWN_ATTACKS[color].squares[sq]; }
+
+inline int Popcount(Bitboard b)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+	return (int)__popcnt64(b);
+#elif defined(_MSC_VER)
+	return (int)(__popcnt((unsigned int)b) + __popcnt((unsigned int)(b >> 32)));
+#else
+	return __builtin_popcountll(b);
+#endif
+}
+
+// Index of the least significant set bit. b must not be empty.
+inline int Lsb(Bitboard b)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, b);
+	return (int)index;
+#elif defined(_MSC_VER)
+	unsigned long index;
+
+	if ((unsigned int)b)
+	{
+		_BitScanForward(&index, (unsigned int)b);
+		return (int)index;
+	}
+
+	_BitScanForward(&index, (unsigned int)(b >> 32));
+	return (int)index + 32;
+#else
+	return __builtin_ctzll(b);
+#endif
+}
+
+inline int PopLsb(Bitboard& b)
+{
+	int sq = Lsb(b);
+	b &= b - 1;
+	return sq;
+}
+
+#if defined(HAS_PEXT)
+inline Bitboard Pext(Bitboard b, Bitboard mask)
+{
+#if defined(_MSC_VER) || defined(__BMI2__)
+	return _pext_u64(b, mask);
+#else
+	// Built without -mbmi2: emit the instruction directly, it only runs when usePext was enabled at startup
+	Bitboard result;
+	__asm__("pextq %2, %1, %0" : "=r"(result) : "r"(b), "r"(mask));
+	return result;
+#endif
+}
+#endif
+
+// Fancy magic bitboards: each square owns a slice of a shared attack table, indexed either by
+// the magic multiplication of the relevant occupancy or, on BMI2 CPUs, by PEXT of the same bits.
+struct Magic
+{
+	Bitboard mask;
+	Bitboard magic;
+	Bitboard* attacks;
+	unsigned shift;
+
+	unsigned index(Bitboard occupied) const;
+};
+
+extern bool usePext;
+extern Magic rookMagics[NUM_SQUARES];
+extern Magic bishopMagics[NUM_SQUARES];
+
+inline unsigned Magic::index(Bitboard occupied) const
+{
+#if defined(HAS_PEXT)
+	if (usePext)
+	{
+		return (unsigned)Pext(occupied, mask);
+	}
+#endif
+
+	return (unsigned)(((occupied & mask) * magic) >> shift);
+}
+
+inline Bitboard RookAttacks(int sq, Bitboard occupied)
+{
+	const Magic& m = rookMagics[sq];
+	return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard BishopAttacks(int sq, Bitboard occupied)
+{
+	const Magic& m = bishopMagics[sq];
+	return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard QueenAttacks(int sq, Bitboard occupied)
+{
+	return RookAttacks(sq, occupied) | BishopAttacks(sq, occupied);
+}
+
+extern Bitboard betweenBB[NUM_SQUARES][NUM_SQUARES];
+extern Bitboard lineBB[NUM_SQUARES][NUM_SQUARES];
+
+// Squares strictly between two squares on a common rank, file or diagonal, empty otherwise
+inline Bitboard BetweenBB(int a, int b) { return betweenBB[a][b]; }
+// The whole rank, file or diagonal through both squares, empty when they are not aligned
+inline Bitboard LineBB(int a, int b) { return lineBB[a][b]; }
+
+// Detects BMI2 and fills the slider attack and line tables. Must run once before any attack lookup.
+void InitBitboards();
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef COLOR_H
+#define COLOR_H
+
+enum Color
+{
+	Black = 1,
+	White = 2
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "Evaluate.h"
+
+namespace
+{
+	// Bonus per square a piece reaches beyond a typical count for it, indexed by Piece
+	const Score MOBILITY_WEIGHT[NUM_PIECE_TYPES] = { { 0, 0 }, { 0, 0 }, { 1, 2 }, { 5, 5 }, { 4, 4 }, { 3, 4 }, { 0, 0 } };
+	const int MOBILITY_BASE[NUM_PIECE_TYPES] = { 0, 0, 14, 7, 4, 7, 0 };
+
+	// Attack units per square of the zone around the enemy king, indexed by Piece
+	const int KING_ATTACK_WEIGHT[NUM_PIECE_TYPES] = { 0, 0, 5, 2, 2, 3, 0 };
+	constexpr int MAX_KING_DANGER = 400;
+
+	// Own pawns one and two ranks in front of a king that stays on its first two ranks
+	constexpr int SHIELD_NEAR = 15;
+	constexpr int SHIELD_FAR = 8;
+
+	template<Piece Pt>
+	Bitboard AttacksFrom(int sq, Bitboard occupied)
+	{
+		return Pt == Piece::Knight ? KnightAttacks(sq)
+			: Pt == Piece::Bishop ? BishopAttacks(sq, occupied)
+			: Pt == Piece::Rook ? RookAttacks(sq, occupied)
+			: QueenAttacks(sq, occupied);
+	}
+
+	struct KingAttack
+	{
+		Bitboard zone;
+		int units;
+		int attackers;
+	};
+
+	// Mobility counts the squares not held by our pieces or covered by enemy pawns
+	template<Color Us, Piece Pt>
+	void EvaluatePiece(const Position& pos, Bitboard area, KingAttack& attack, Score& score)
+	{
+		for (Bitboard b = pos.pieces(Us, Pt); b; )
+		{
+			Bitboard attacks = AttacksFrom<Pt>(PopLsb(b), pos.occupied());
+			int mobility = Popcount(attacks & area) - MOBILITY_BASE[Pt];
+
+			score.mg += MOBILITY_WEIGHT[Pt].mg * mobility;
+			score.eg += MOBILITY_WEIGHT[Pt].eg * mobility;
+
+			if (attacks & attack.zone)
+			{
+				attack.units += KING_ATTACK_WEIGHT[Pt] * Popcount(attacks & attack.zone);
+				attack.attackers++;
+			}
+		}
+	}
+
+	// Mobility and king safety of one side, from its own point of view
+	template<Color Us>
+	Score EvaluateSide(const Position& pos, const PawnEntry& pawns)
+	{
+		constexpr Color Them = Us == Color::White ? Color::Black : Color::White;
+
+		Score score = { 0, 0 };
+		Bitboard area = ~pos.pieces(Us) & ~pawns.attacks[Them];
+		int theirKing = pos.kingSquare(Them);
+		KingAttack attack = { KingAttacks(theirKing) | SquareBB(theirKing), 0, 0 };
+
+		EvaluatePiece<Us, Piece::Knight>(pos, area, attack, score);
+		EvaluatePiece<Us, Piece::Bishop>(pos, area, attack, score);
+		EvaluatePiece<Us, Piece::Rook>(pos, area, attack, score);
+		EvaluatePiece<Us, Piece::Queen>(pos, area, attack, score);
+
+		// A lone attacker is easily met; danger grows with the square of the pressure
+		if (attack.attackers >= 2)
+		{
+			int danger = attack.units * attack.units / 4;
+			score.mg += danger < MAX_KING_DANGER ? danger : MAX_KING_DANGER;
+		}
+
+		int ourKing = pos.kingSquare(Us);
+		int relativeRank = Us == Color::White ? RankOf(ourKing) : 7 - RankOf(ourKing);
+
+		if (relativeRank <= 1)
+		{
+			Bitboard row = (KingAttacks(ourKing) | SquareBB(ourKing)) & (RANK_1_BB << (8 * RankOf(ourKing)));
+			Bitboard near = Us == Color::White ? row << 8 : row >> 8;
+			Bitboard far = Us == Color::White ? row << 16 : row >> 16;
+			Bitboard pawns = pos.pieces(Us, Piece::Pawn);
+
+			score.mg += SHIELD_NEAR * Popcount(pawns & near) + SHIELD_FAR * Popcount(pawns & far);
+		}
+
+		return score;
+	}
+}
+
+int Evaluate(const Position& pos, PawnTable& pawnTable, MaterialTable& materialTable)
+{
+	const PawnEntry& pawns = ProbePawns(pos, pawnTable);
+	const MaterialEntry& material = ProbeMaterial(pos, materialTable);
+	Score psq = pos.psq();
+	Score white = EvaluateSide<Color::White>(pos, pawns);
+	Score black = EvaluateSide<Color::Black>(pos, pawns);
+
+	int mg = psq.mg + pawns.score.mg + material.imbalance.mg + white.mg - black.mg;
+	int eg = psq.eg + pawns.score.eg + material.imbalance.eg + white.eg - black.eg;
+
+	// Promotions can push the phase past its starting value
+	int phase = pos.phase() < MAX_PHASE ? pos.phase() : MAX_PHASE;
+	int score = (mg * phase + eg * (MAX_PHASE - phase)) / MAX_PHASE;
+
+	return pos.sideToMove() == Color::White ? score : -score;
+}
@@ -0,0 +1,18 @@
+#ifndef EVALUATE_H
+#define EVALUATE_H
+
+#include "Material.h"
+#include "Pawns.h"
+#include "Position.h"
+
+// Centipawn values indexed by Piece, for exchanges and move ordering; the king is never traded,
+// so it counts for nothing
+constexpr int PIECE_VALUE[NUM_PIECE_TYPES] = { 0, 0, 900, 330, 320, 500, 100 };
+
+// Static score of the position in centipawns, from the point of view of the side to move.
+// Material and piece-square scores come ready from the position, pawn structure and material
+// imbalance from the caller's caches; mobility and king safety are added here, and the
+// middlegame and endgame halves are blended by the game phase.
+int Evaluate(const Position& pos, PawnTable& pawnTable, MaterialTable& materialTable);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef HASHTABLE_H
+#define HASHTABLE_H
+
+#include <cstdint>
+#include <cstring>
+
+// Direct-mapped cache of evaluation terms. Each search thread owns its tables, so they need no
+// locking. Entry is a plain struct starting with a uint64_t key; a slot taken by another key is
+// simply overwritten. Size must be a power of two.
+template<typename Entry, int Size>
+class HashTable
+{
+public:
+	HashTable() { clear(); }
+
+	void clear()
+	{
+		memset(entries, 0, sizeof(entries));
+		resetStats();
+	}
+
+	// The slot of key; hit tells whether it already holds the entry of that key
+	Entry& probe(uint64_t key, bool& hit)
+	{
+		Entry& entry = entries[key & (Size - 1)];
+
+		hit = entry.key == key;
+		probeCount++;
+		hitCount += hit;
+
+		return entry;
+	}
+
+	uint64_t probes() const { return probeCount; }
+	uint64_t hits() const { return hitCount; }
+	void resetStats() { probeCount = hitCount = 0; }
+
+private:
+	Entry entries[Size];
+	uint64_t probeCount;
+	uint64_t hitCount;
+};
+
+#endif
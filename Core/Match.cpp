@@ -0,0 +1,121 @@
+#include "Match.h"
+
+Match::Match(size_t hashMegabytes) : selected(NO_SQUARE), engineWhite(false), engineBlack(false),
+	engineLimits(MATCH_ENGINE_LIMITS), hashSize(hashMegabytes), checkmate(false), draw(false)
+{
+	position.setStartPosition();
+}
+
+void Match::setEngineSides(bool white, bool black)
+{
+	engineWhite = white;
+	engineBlack = black;
+
+	if ((white || black) && !engine)
+	{
+		engine.reset(new SearchThread(hashSize));
+	}
+}
+
+Move Match::click(int sq)
+{
+	if (selected != NO_SQUARE)
+	{
+		Move move = findMove(sq);
+
+		if (sq != selected && move == NO_MOVE)
+		{
+			return NO_MOVE;
+		}
+
+		selected = NO_SQUARE;
+		moves.clear();
+
+		if (move != NO_MOVE)
+		{
+			play(move);
+		}
+
+		return move;
+	}
+
+	if (isOver() || isEngineTurn() || position.isEmpty(sq) || position.colorOn(sq) != position.sideToMove())
+	{
+		return NO_MOVE;
+	}
+
+	MoveList legal(position);
+
+	selected = sq;
+
+	for (Move move : legal)
+	{
+		if (FromSquare(move) == sq)
+		{
+			moves.add(move);
+		}
+	}
+
+	return NO_MOVE;
+}
+
+Move Match::updateEngine()
+{
+	SearchInfo info;
+
+	if (!engine)
+	{
+		return NO_MOVE;
+	}
+
+	if (engine->poll(info))
+	{
+		if (!info.finished)
+		{
+			if (onProgress)
+			{
+				onProgress(info.result);
+			}
+		}
+		else if (info.result.bestMove != NO_MOVE)
+		{
+			play(info.result.bestMove);
+			return info.result.bestMove;
+		}
+	}
+	else if (!engine->isBusy() && !isOver() && isEngineTurn())
+	{
+		engine->start(position, engineLimits);
+	}
+
+	return NO_MOVE;
+}
+
+Move Match::findMove(int to) const
+{
+	for (Move move : moves)
+	{
+		if (ToSquare(move) == to && (!IsPromotion(move) || PromotionPiece(move) == Piece::Queen))
+		{
+			return move;
+		}
+	}
+
+	return NO_MOVE;
+}
+
+void Match::play(Move move)
+{
+	position.make(move);
+
+	// No legal move is checkmate, or stalemate when the king is not in check
+	bool hasMoves = !MoveList(position).empty();
+
+	checkmate = !hasMoves && position.inCheck();
+	draw = (!hasMoves && !position.inCheck()) || position.isThreefoldRepetition() || position.isFiftyMoveDraw();
+}
+
+bool Match::isEngineTurn() const
+{
+	return position.sideToMove() == Color::White ? engineWhite : engineBlack;
+}
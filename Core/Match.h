@@ -0,0 +1,80 @@
+#ifndef MATCH_H
+#define MATCH_H
+
+#include <functional>
+#include <memory>
+
+#include "MoveList.h"
+#include "Position.h"
+#include "SearchThread.h"
+
+// Defaults of a match: a second per engine move and a table small enough for thousands of matches
+// in one process
+constexpr SearchLimits MATCH_ENGINE_LIMITS = { 0, 1000, 0 };
+constexpr size_t MATCH_HASH_MB = 1;
+
+// One game without any drawing: the position, the piece the player selected, the result and the
+// engine playing either side. The turn is always the position's side to move. Nothing is shared
+// between instances, so a process can run many matches at once, each on a thread of its own. The
+// graphical game wraps one and moves its sprites with the moves it reports.
+class Match
+{
+public:
+	// Size of the engine's transposition table, allocated once some side is the engine's
+	explicit Match(size_t hashMegabytes = MATCH_HASH_MB);
+
+	// Sides played by the engine; with both set the match plays itself. The search is only created
+	// once some side is the engine's.
+	void setEngineSides(bool white, bool black);
+	// Budget of every engine move: depth, milliseconds and nodes (0 = no limit), MATCH_ENGINE_LIMITS
+	// until set
+	void setEngineLimits(const SearchLimits& limits) { engineLimits = limits; }
+	// Null while no side is the engine's
+	SearchThread* searchThread() { return engine.get(); }
+
+	// The player's click on a square. With nothing selected it selects a piece of the side to move,
+	// unless the engine plays that side. With a piece selected, a click on one of its destinations
+	// plays the move and a click on the piece itself drops the selection. Returns the move played,
+	// NO_MOVE otherwise.
+	Move click(int sq);
+	// Called regularly: starts the search on the engine's turn and plays its move once it is done.
+	// Never waits for the search thread. Returns the move played, NO_MOVE otherwise.
+	Move updateEngine();
+
+	// Called by updateEngine() for every completed iteration, on the match's thread. Unset, the
+	// progress goes nowhere.
+	std::function<void(const SearchResult&)> onProgress;
+
+	// NO_SQUARE while no piece is selected
+	int selectedSquare() const { return selected; }
+	// Legal moves of the selected piece
+	const MoveList& selectedMoves() const { return moves; }
+
+	bool isOver() const { return checkmate || draw; }
+	bool isCheckmate() const { return checkmate; }
+	// Stalemate, threefold repetition or the 50-move rule
+	bool isDraw() const { return draw; }
+	const Position& board() const { return position; }
+
+private:
+	// A pawn reaching the last rank always becomes a queen
+	Move findMove(int to) const;
+	void play(Move move);
+	bool isEngineTurn() const;
+
+	Position position;
+	int selected;
+	MoveList moves;
+
+	bool engineWhite;
+	bool engineBlack;
+	SearchLimits engineLimits;
+	size_t hashSize;
+	// The search runs on threads of its own, the match only polls it
+	std::unique_ptr<SearchThread> engine;
+
+	bool checkmate;
+	bool draw;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#include "Material.h"
+
+namespace
+{
+	const Score BISHOP_PAIR = { 30, 50 };
+	// Per own pawn above five: knights gain with closed positions, rooks want open files
+	const Score KNIGHT_PAWN_ADJUSTMENT = { 3, 3 };
+	const Score ROOK_PAWN_ADJUSTMENT = { -6, -6 };
+
+	template<Color Us>
+	Score Imbalance(const Position& pos)
+	{
+		Score score = { 0, 0 };
+		int pawns = Popcount(pos.pieces(Us, Piece::Pawn)) - 5;
+		int knights = Popcount(pos.pieces(Us, Piece::Knight));
+		int rooks = Popcount(pos.pieces(Us, Piece::Rook));
+
+		if (Popcount(pos.pieces(Us, Piece::Bishop)) >= 2)
+		{
+			score.mg += BISHOP_PAIR.mg;
+			score.eg += BISHOP_PAIR.eg;
+		}
+
+		score.mg += (KNIGHT_PAWN_ADJUSTMENT.mg * knights + ROOK_PAWN_ADJUSTMENT.mg * rooks) * pawns;
+		score.eg += (KNIGHT_PAWN_ADJUSTMENT.eg * knights + ROOK_PAWN_ADJUSTMENT.eg * rooks) * pawns;
+
+		return score;
+	}
+}
+
+const MaterialEntry& ProbeMaterial(const Position& pos, MaterialTable& table)
+{
+	bool hit;
+	MaterialEntry& entry = table.probe(pos.materialKey(), hit);
+
+	if (!hit)
+	{
+		Score white = Imbalance<Color::White>(pos);
+		Score black = Imbalance<Color::Black>(pos);
+
+		entry.key = pos.materialKey();
+		entry.imbalance = { white.mg - black.mg, white.eg - black.eg };
+	}
+
+	return entry;
+}
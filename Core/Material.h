@@ -0,0 +1,20 @@
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include "HashTable.h"
+#include "Position.h"
+
+// Material imbalance terms, which only change on captures and promotions
+struct MaterialEntry
+{
+	uint64_t key;
+	// Bishop pair and the pawn count adjustments of knights and rooks, from White's point of view
+	Score imbalance;
+};
+
+typedef HashTable<MaterialEntry, 4096> MaterialTable;
+
+// The entry of the piece counts of pos, computed on a miss
+const MaterialEntry& ProbeMaterial(const Position& pos, MaterialTable& table);
+
+#endif
@@ -0,0 +1,41 @@
+#include "Memory.h"
+
+#include <cstdlib>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+void* AlignedAlloc(size_t alignment, size_t size)
+{
+#if defined(_MSC_VER)
+	return _aligned_malloc(size, alignment);
+#else
+	void* memory = nullptr;
+	return posix_memalign(&memory, alignment, size) == 0 ? memory : nullptr;
+#endif
+}
+
+void AlignedFree(void* memory)
+{
+#if defined(_MSC_VER)
+	_aligned_free(memory);
+#else
+	free(memory);
+#endif
+}
+
+bool AdviseHugePages(void* memory, size_t size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	return madvise(memory, size, MADV_HUGEPAGE) == 0;
+#else
+	(void)memory;
+	(void)size;
+	return false;
+#endif
+}
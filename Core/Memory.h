@@ -0,0 +1,18 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <cstddef>
+
+constexpr size_t MEMORY_PAGE_SIZE = 4096;
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Heap blocks with a given alignment, which plain new only guarantees from C++17 on.
+// Returns nullptr when the memory is not available.
+void* AlignedAlloc(size_t alignment, size_t size);
+void AlignedFree(void* memory);
+
+// Asks the kernel to back a huge-page-aligned block with transparent huge pages, cutting TLB misses
+// on large tables. Linux only; returns false elsewhere or when the kernel refuses.
+bool AdviseHugePages(void* memory, size_t size);
+
+#endif
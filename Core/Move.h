@@ -0,0 +1,74 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstdint>
+#include <string>
+
+#include "Piece.cpp"
+
+// A move packed in 16 bits: origin square in bits 0-5, destination in bits 6-11 and flags in bits 12-15.
+// Flag bit 2 marks captures and flag bit 3 promotions; the low two bits then select the new piece.
+typedef uint16_t Move;
+
+constexpr Move NO_MOVE = 0;
+
+enum MoveFlag
+{
+	Quiet = 0,
+	DoublePush = 1,
+	KingCastle = 2,
+	QueenCastle = 3,
+	Capture = 4,
+	EnPassant = 5,
+	KnightPromotion = 8,
+	BishopPromotion = 9,
+	RookPromotion = 10,
+	QueenPromotion = 11,
+	KnightPromotionCapture = 12,
+	BishopPromotionCapture = 13,
+	RookPromotionCapture = 14,
+	QueenPromotionCapture = 15
+};
+
+constexpr Move EncodeMove(int from, int to, int flags) { return (Move)(from | (to << 6) | (flags << 12)); }
+constexpr int FromSquare(Move move) { return move & 0x3F; }
+constexpr int ToSquare(Move move) { return (move >> 6) & 0x3F; }
+constexpr int MoveFlags(Move move) { return move >> 12; }
+constexpr bool IsCapture(Move move) { return (move & 0x4000) != 0; }
+constexpr bool IsPromotion(Move move) { return (move & 0x8000) != 0; }
+constexpr bool IsCastle(Move move) { return MoveFlags(move) == KingCastle || MoveFlags(move) == QueenCastle; }
+
+inline Piece PromotionPiece(Move move)
+{
+	const Piece pieces[4] = { Piece::Knight, Piece::Bishop, Piece::Rook, Piece::Queen };
+	return pieces[MoveFlags(move) & 3];
+}
+
+// Rook squares of a castling move, given the king's origin and destination
+inline void CastlingRookSquares(Move move, int& rookFrom, int& rookTo)
+{
+	bool kingSide = MoveFlags(move) == KingCastle;
+
+	rookFrom = kingSide ? ToSquare(move) + 1 : ToSquare(move) - 2;
+	rookTo = kingSide ? ToSquare(move) - 1 : ToSquare(move) + 1;
+}
+
+// Coordinate notation as used by UCI, e.g. e2e4, e1g1 for castling and a7a8q for promotions
+inline std::string MoveToString(Move move)
+{
+	std::string text;
+
+	text += char('a' + (FromSquare(move) & 7));
+	text += char('1' + (FromSquare(move) >> 3));
+	text += char('a' + (ToSquare(move) & 7));
+	text += char('1' + (ToSquare(move) >> 3));
+
+	if (IsPromotion(move))
+	{
+		text += "nbrq"[MoveFlags(move) & 3];
+	}
+
+	return text;
+}
+
+#endif
@@ -0,0 +1,303 @@
+#include "MoveGen.h"
+
+namespace
+{
+	// Board shifts by a compile-time step; the direction test folds away in each instantiation
+	template<int Step>
+	constexpr Bitboard Shift(Bitboard b)
+	{
+		return Step > 0 ? b << Step : b >> -Step;
+	}
+
+	template<Piece Pt>
+	Bitboard Attacks(int sq, Bitboard occupied);
+
+	template<>
+	Bitboard Attacks<Piece::Knight>(int sq, Bitboard) { return KnightAttacks(sq); }
+
+	template<>
+	Bitboard Attacks<Piece::Bishop>(int sq, Bitboard occupied) { return BishopAttacks(sq, occupied); }
+
+	template<>
+	Bitboard Attacks<Piece::Rook>(int sq, Bitboard occupied) { return RookAttacks(sq, occupied); }
+
+	template<>
+	Bitboard Attacks<Piece::Queen>(int sq, Bitboard occupied) { return QueenAttacks(sq, occupied); }
+
+	template<int Step>
+	Move* AddPawnMoves(Move* list, Bitboard targets, int flags)
+	{
+		while (targets)
+		{
+			int to = PopLsb(targets);
+			*list++ = EncodeMove(to - Step, to, flags);
+		}
+
+		return list;
+	}
+
+	template<int Step>
+	Move* AddPromotions(Move* list, Bitboard targets, bool capture)
+	{
+		int flags = capture ? MoveFlag::KnightPromotionCapture : MoveFlag::KnightPromotion;
+
+		while (targets)
+		{
+			int to = PopLsb(targets);
+
+			for (int i = 0; i < 4; i++)
+			{
+				*list++ = EncodeMove(to - Step, to, flags + i);
+			}
+		}
+
+		return list;
+	}
+
+	Move* AddMoves(Move* list, int from, Bitboard targets, Bitboard enemies)
+	{
+		while (targets)
+		{
+			int to = PopLsb(targets);
+			*list++ = EncodeMove(from, to, (enemies & SquareBB(to)) ? MoveFlag::Capture : MoveFlag::Quiet);
+		}
+
+		return list;
+	}
+
+	// Pins hide a horizontal case here: both pawns leave the king's rank at once, so the capture is
+	// tested directly against the sliders with the resulting occupancy.
+	template<Color Us>
+	bool IsLegalEnPassant(const Position& pos, int from, int to)
+	{
+		constexpr Color Them = Us == Color::White ? Color::Black : Color::White;
+		constexpr int Down = Us == Color::White ? -8 : 8;
+
+		int ksq = pos.kingSquare(Us);
+		int captured = to + Down;
+		Bitboard occupied = (pos.occupied() ^ SquareBB(from) ^ SquareBB(captured)) | SquareBB(to);
+
+		return !(pos.attackersTo(ksq, occupied) & pos.pieces(Them) & ~SquareBB(captured));
+	}
+
+	// Set-wise moves of a group of pawns that may only land on mask
+	template<GenType Gen, Color Us>
+	Move* GeneratePawnMoves(const Position& pos, Move* list, Bitboard pawns, Bitboard mask)
+	{
+		constexpr Color Them = Us == Color::White ? Color::Black : Color::White;
+		constexpr int Up = Us == Color::White ? 8 : -8;
+		constexpr int UpLeft = Us == Color::White ? 7 : -9;
+		constexpr int UpRight = Us == Color::White ? 9 : -7;
+		constexpr Bitboard LastRank = Us == Color::White ? RANK_8_BB : RANK_1_BB;
+		constexpr Bitboard DoublePushRank = Us == Color::White ? RANK_3_BB : RANK_6_BB;
+
+		Bitboard empty = ~pos.occupied();
+		Bitboard enemies = pos.pieces(Them) & mask;
+
+		Bitboard single = Shift<Up>(pawns) & empty;
+		Bitboard twice = Shift<Up>(single & DoublePushRank) & empty & mask;
+		Bitboard left = Shift<UpLeft>(pawns & ~FILE_A_BB) & enemies;
+		Bitboard right = Shift<UpRight>(pawns & ~FILE_H_BB) & enemies;
+
+		single &= mask;
+
+		if (Gen != Captures)
+		{
+			list = AddPawnMoves<Up>(list, single & ~LastRank, MoveFlag::Quiet);
+			list = AddPawnMoves<2 * Up>(list, twice, MoveFlag::DoublePush);
+		}
+
+		if (Gen == Quiets)
+		{
+			return list;
+		}
+
+		list = AddPawnMoves<UpLeft>(list, left & ~LastRank, MoveFlag::Capture);
+		list = AddPawnMoves<UpRight>(list, right & ~LastRank, MoveFlag::Capture);
+
+		if ((single | left | right) & LastRank)
+		{
+			list = AddPromotions<Up>(list, single & LastRank, false);
+			list = AddPromotions<UpLeft>(list, left & LastRank, true);
+			list = AddPromotions<UpRight>(list, right & LastRank, true);
+		}
+
+		return list;
+	}
+
+	// Moves of the pieces on sources that land on mask
+	template<Color Us, Piece Pt>
+	Move* GeneratePieceMoves(const Position& pos, Move* list, Bitboard sources, Bitboard mask, Bitboard pinned)
+	{
+		constexpr Color Them = Us == Color::White ? Color::Black : Color::White;
+
+		int ksq = pos.kingSquare(Us);
+		Bitboard occupied = pos.occupied();
+		Bitboard enemies = pos.pieces(Them);
+
+		// A pinned knight can never stay on the line through its king
+		Bitboard pieces = pos.pieces(Us, Pt) & sources & (Pt == Piece::Knight ? ~pinned : ~0ULL);
+
+		while (pieces)
+		{
+			int from = PopLsb(pieces);
+			Bitboard targets = Attacks<Pt>(from, occupied) & mask;
+
+			if (pinned & SquareBB(from))
+			{
+				targets &= LineBB(ksq, from);
+			}
+
+			list = AddMoves(list, from, targets, enemies);
+		}
+
+		return list;
+	}
+
+	template<Color Us>
+	Move* GenerateCastling(const Position& pos, Move* list)
+	{
+		constexpr Color Them = Us == Color::White ? Color::Black : Color::White;
+		constexpr int KingSide = Us == Color::White ? WhiteKingSide : BlackKingSide;
+		constexpr int QueenSide = Us == Color::White ? WhiteQueenSide : BlackQueenSide;
+		constexpr int King = MakeSquare(4, Us == Color::White ? 0 : 7);
+
+		// The rights alone are not trusted: the king and the rook must still stand on their squares
+		if (!(pos.pieces(Us, Piece::King) & SquareBB(King)))
+		{
+			return list;
+		}
+
+		if ((pos.castlingRights() & KingSide) && (pos.pieces(Us, Piece::Rook) & SquareBB(King + 3))
+			&& pos.isEmpty(King + 1) && pos.isEmpty(King + 2)
+			&& !pos.isAttacked(King + 1, Them) && !pos.isAttacked(King + 2, Them))
+		{
+			*list++ = EncodeMove(King, King + 2, MoveFlag::KingCastle);
+		}
+
+		if ((pos.castlingRights() & QueenSide) && (pos.pieces(Us, Piece::Rook) & SquareBB(King - 4))
+			&& pos.isEmpty(King - 1) && pos.isEmpty(King - 2) && pos.isEmpty(King - 3)
+			&& !pos.isAttacked(King - 1, Them) && !pos.isAttacked(King - 2, Them))
+		{
+			*list++ = EncodeMove(King, King - 2, MoveFlag::QueenCastle);
+		}
+
+		return list;
+	}
+
+	// Moves of the pieces on sources only, all of them for a whole move list
+	template<GenType Gen, Color Us>
+	Move* Generate(const Position& pos, Move* list, Bitboard sources)
+	{
+		constexpr Color Them = Us == Color::White ? Color::Black : Color::White;
+
+		int ksq = pos.kingSquare(Us);
+		Bitboard enemies = pos.pieces(Them);
+		Bitboard checkers = pos.checkers();
+
+		// Captures land on enemy pieces, quiet moves on empty squares
+		Bitboard targets = Gen == Captures ? enemies : Gen == Quiets ? ~pos.occupied() : ~pos.pieces(Us);
+
+		// The king is tested with itself removed, so it cannot step back along the checking ray
+		Bitboard withoutKing = pos.occupied() ^ SquareBB(ksq);
+
+		for (Bitboard b = (sources & SquareBB(ksq)) ? KingAttacks(ksq) & targets : 0; b; )
+		{
+			int to = PopLsb(b);
+
+			if (!(pos.attackersTo(to, withoutKing) & enemies))
+			{
+				*list++ = EncodeMove(ksq, to, (enemies & SquareBB(to)) ? MoveFlag::Capture : MoveFlag::Quiet);
+			}
+		}
+
+		// Against a double check only the king can move
+		if (checkers & (checkers - 1))
+		{
+			return list;
+		}
+
+		// Squares that capture the checker or block its ray; anything not our own when not in check
+		Bitboard checkMask = checkers ? BetweenBB(ksq, Lsb(checkers)) | checkers : ~pos.pieces(Us);
+		Bitboard pinned = pos.pinned(Us, Them) & pos.pieces(Us);
+		Bitboard pawns = pos.pieces(Us, Piece::Pawn) & sources;
+
+		list = GeneratePawnMoves<Gen, Us>(pos, list, pawns & ~pinned, checkMask);
+
+		for (Bitboard b = pawns & pinned; b; )
+		{
+			int from = PopLsb(b);
+			list = GeneratePawnMoves<Gen, Us>(pos, list, SquareBB(from), checkMask & LineBB(ksq, from));
+		}
+
+		if (Gen != Quiets && pos.epSquare() != NO_SQUARE)
+		{
+			for (Bitboard b = PawnAttacks(Them, pos.epSquare()) & pawns; b; )
+			{
+				int from = PopLsb(b);
+
+				if (IsLegalEnPassant<Us>(pos, from, pos.epSquare()))
+				{
+					*list++ = EncodeMove(from, pos.epSquare(), MoveFlag::EnPassant);
+				}
+			}
+		}
+
+		list = GeneratePieceMoves<Us, Piece::Knight>(pos, list, sources, checkMask & targets, pinned);
+		list = GeneratePieceMoves<Us, Piece::Bishop>(pos, list, sources, checkMask & targets, pinned);
+		list = GeneratePieceMoves<Us, Piece::Rook>(pos, list, sources, checkMask & targets, pinned);
+		list = GeneratePieceMoves<Us, Piece::Queen>(pos, list, sources, checkMask & targets, pinned);
+
+		if (Gen != Captures && !checkers && (sources & SquareBB(ksq)))
+		{
+			list = GenerateCastling<Us>(pos, list);
+		}
+
+		return list;
+	}
+
+	template<GenType Gen>
+	Move* Generate(const Position& pos, Move* list, Bitboard sources)
+	{
+		return pos.sideToMove() == Color::White
+			? Generate<Gen, Color::White>(pos, list, sources)
+			: Generate<Gen, Color::Black>(pos, list, sources);
+	}
+}
+
+Move* GenerateLegal(const Position& pos, Move* list, GenType type)
+{
+	switch (type)
+	{
+	case Captures:
+		return Generate<Captures>(pos, list, ~0ULL);
+	case Quiets:
+		return Generate<Quiets>(pos, list, ~0ULL);
+	default:
+		return Generate<AllMoves>(pos, list, ~0ULL);
+	}
+}
+
+bool IsLegal(const Position& pos, Move move)
+{
+	int from = FromSquare(move);
+
+	if (move == NO_MOVE || pos.isEmpty(from) || pos.colorOn(from) != pos.sideToMove())
+	{
+		return false;
+	}
+
+	// A queen in the middle of an empty board has the most moves of any single piece
+	Move moves[32];
+	Move* end = Generate<AllMoves>(pos, moves, SquareBB(from));
+
+	for (Move* m = moves; m != end; m++)
+	{
+		if (*m == move)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,27 @@
+#ifndef MOVEGEN_H
+#define MOVEGEN_H
+
+#include "Move.h"
+#include "Position.h"
+
+// No chess position has more legal moves than this
+constexpr int MAX_MOVES = 256;
+
+// Captures holds every capture and promotion, Quiets everything else, so the two split AllMoves
+enum GenType
+{
+	Captures,
+	Quiets,
+	AllMoves
+};
+
+// Appends the legal moves of the given kind for the side to move to list and returns the new end.
+// Checkers and pinned pieces are computed once; each move is then limited to the squares that
+// resolve a check and, for pinned pieces, to the line through their king. Nothing is played.
+Move* GenerateLegal(const Position& pos, Move* list, GenType type = AllMoves);
+
+// Whether a move that did not come from the generator, such as a hash move, is legal here.
+// Only the moves of the piece on its origin square are generated.
+bool IsLegal(const Position& pos, Move move);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef MOVELIST_H
+#define MOVELIST_H
+
+#include "MoveGen.h"
+
+// Fixed-capacity list of encoded moves that lives on the stack, so generating moves never allocates
+class MoveList
+{
+public:
+	MoveList() : count(0) {}
+	// The legal moves of the position
+	explicit MoveList(const Position& pos) : count((int)(GenerateLegal(pos, moves) - moves)) {}
+
+	void add(Move move) { moves[count++] = move; }
+	void clear() { count = 0; }
+
+	int size() const { return count; }
+	bool empty() const { return count == 0; }
+	Move operator[](int i) const { return moves[i]; }
+	Move& operator[](int i) { return moves[i]; }
+
+	const Move* begin() const { return moves; }
+	const Move* end() const { return moves + count; }
+	Move* begin() { return moves; }
+	Move* end() { return moves + count; }
+
+	bool contains(Move move) const
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if (moves[i] == move)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+private:
+	Move moves[MAX_MOVES];
+	int count;
+};
+
+#endif
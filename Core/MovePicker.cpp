@@ -0,0 +1,170 @@
+#include "MovePicker.h"
+
+#include "Evaluate.h"
+#include "See.h"
+
+MovePicker::MovePicker(const Position& position, Move hashMove, const Move killerMoves[2],
+	const int (*butterfly)[NUM_SQUARES], const int (*counter)[NUM_SQUARES])
+	: pos(position), ttMove(hashMove), history(butterfly), counterHistory(counter), stage(HashMove),
+	skipQuiets(false), current(0), end(0), badEnd(0)
+{
+	killers[0] = killerMoves[0];
+	killers[1] = killerMoves[1];
+
+	if (ttMove != NO_MOVE && !IsLegal(pos, ttMove))
+	{
+		ttMove = NO_MOVE;
+	}
+}
+
+Move MovePicker::next()
+{
+	switch (stage)
+	{
+	case HashMove:
+		stage = InitCaptures;
+
+		if (ttMove != NO_MOVE)
+		{
+			return ttMove;
+		}
+
+		return next();
+
+	case InitCaptures:
+		end = (int)(GenerateLegal(pos, moves, Captures) - moves);
+		scoreCaptures();
+		sort(0, end);
+		stage = GoodCaptures;
+		return next();
+
+	case GoodCaptures:
+		while (current < end)
+		{
+			Move move = moves[current++];
+
+			if (move == ttMove)
+			{
+				continue;
+			}
+
+			if (See(pos, move) < 0)
+			{
+				moves[badEnd++] = move;
+				continue;
+			}
+
+			return move;
+		}
+
+		stage = FirstKiller;
+		return next();
+
+	case FirstKiller:
+	case SecondKiller:
+	{
+		Move killer = killers[stage - FirstKiller];
+		stage = Stage(stage + 1);
+
+		// Killers come from sibling nodes, so they are only played while still a legal quiet move here
+		if (!skipQuiets && killer != NO_MOVE && killer != ttMove && !IsCapture(killer) && !IsPromotion(killer) && IsLegal(pos, killer))
+		{
+			return killer;
+		}
+
+		return next();
+	}
+
+	case InitQuiets:
+		if (skipQuiets)
+		{
+			current = 0;
+			stage = BadCaptures;
+			return next();
+		}
+
+		current = end;
+		end = (int)(GenerateLegal(pos, moves + current, Quiets) - moves);
+		scoreQuiets();
+		sort(current, end);
+		stage = QuietMoves;
+		return next();
+
+	case QuietMoves:
+		while (!skipQuiets && current < end)
+		{
+			Move move = moves[current++];
+
+			if (!isSpecial(move))
+			{
+				return move;
+			}
+		}
+
+		current = 0;
+		stage = BadCaptures;
+		return next();
+
+	case BadCaptures:
+		if (current < badEnd)
+		{
+			return moves[current++];
+		}
+
+		stage = Done;
+		return NO_MOVE;
+
+	default:
+		return NO_MOVE;
+	}
+}
+
+void MovePicker::scoreCaptures()
+{
+	for (int i = 0; i < end; i++)
+	{
+		Move move = moves[i];
+		Piece victim = MoveFlags(move) == MoveFlag::EnPassant ? Piece::Pawn : pos.pieceOn(ToSquare(move));
+
+		scores[i] = 16 * PIECE_VALUE[victim] - PIECE_VALUE[pos.pieceOn(FromSquare(move))];
+
+		if (IsPromotion(move))
+		{
+			scores[i] += 16 * PIECE_VALUE[PromotionPiece(move)];
+		}
+	}
+}
+
+void MovePicker::scoreQuiets()
+{
+	for (int i = current; i < end; i++)
+	{
+		Move move = moves[i];
+		scores[i] = history[FromSquare(move)][ToSquare(move)];
+
+		if (counterHistory)
+		{
+			scores[i] += counterHistory[pos.pieceOn(FromSquare(move))][ToSquare(move)];
+		}
+	}
+}
+
+// Insertion sort, best score first: lists are short
+void MovePicker::sort(int first, int last)
+{
+	for (int i = first + 1; i < last; i++)
+	{
+		Move move = moves[i];
+		int score = scores[i];
+		int j = i - 1;
+
+		for (; j >= first && scores[j] < score; j--)
+		{
+			moves[j + 1] = moves[j];
+			scores[j + 1] = scores[j];
+		}
+
+		moves[j + 1] = move;
+		scores[j + 1] = score;
+	}
+}
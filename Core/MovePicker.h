@@ -0,0 +1,59 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include "MoveGen.h"
+
+// Hands out the moves of a node one at a time in stages: the hash move, captures that do not lose
+// material by most valuable victim and least valuable attacker, the killers, quiet moves by history
+// and last the captures that lose material. Each kind of move is only generated when its stage is
+// reached, so a cutoff on an early move skips generating the rest.
+class MovePicker
+{
+public:
+	// history is the butterfly table [from][to] of the side to move. counterHistory is the
+	// [piece][to] table that follows the opponent's last move, or nullptr when there is none.
+	MovePicker(const Position& pos, Move ttMove, const Move killers[2], const int (*history)[NUM_SQUARES],
+		const int (*counterHistory)[NUM_SQUARES]);
+
+	// NO_MOVE once every legal move has been returned
+	Move next();
+	// The remaining killers and quiet moves are dropped, and the quiet moves are not even generated
+	void skipQuietMoves() { skipQuiets = true; }
+
+private:
+	enum Stage
+	{
+		HashMove,
+		InitCaptures,
+		GoodCaptures,
+		FirstKiller,
+		SecondKiller,
+		InitQuiets,
+		QuietMoves,
+		BadCaptures,
+		Done
+	};
+
+	bool isSpecial(Move move) const { return move == ttMove || move == killers[0] || move == killers[1]; }
+	void scoreCaptures();
+	void scoreQuiets();
+	void sort(int first, int last);
+
+	const Position& pos;
+	Move ttMove;
+	Move killers[2];
+	const int (*history)[NUM_SQUARES];
+	const int (*counterHistory)[NUM_SQUARES];
+	Stage stage;
+	bool skipQuiets;
+
+	// Captures fill the front of the list, losing ones are moved back over those already returned,
+	// and the quiet moves follow the captures
+	Move moves[MAX_MOVES];
+	int scores[MAX_MOVES];
+	int current;
+	int end;
+	int badEnd;
+};
+
+#endif
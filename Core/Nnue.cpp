@@ -0,0 +1,359 @@
+#include "Nnue.h"
+
+#include <cstring>
+
+#include "NnueKernels.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(NnueNetwork::Header) == 64, "the header takes one cache line");
+static_assert(sizeof(NnueNetwork) == 64 + 512 + 20971520 + 128 + 16384 + 128 + 1024 + 64 + 64,
+	"network file layout must not depend on the compiler");
+
+namespace
+{
+	// Feature block of each piece type, by Piece; kings are not features
+	constexpr int PIECE_FEATURE[NUM_PIECE_TYPES] = { -1, -1, 4, 2, 1, 3, 0 };
+
+	// Scores are kept well inside the range of mate scores
+	constexpr int MAX_EVAL = 10000;
+
+	// A mapped network file; the handle is the file mapping object on Windows and unused elsewhere
+	struct MappedNetwork
+	{
+		const NnueNetwork* net;
+		void* handle;
+	};
+
+	void Unmap(const MappedNetwork& mapped)
+	{
+#if defined(_WIN32)
+		UnmapViewOfFile(mapped.net);
+		CloseHandle(mapped.handle);
+#else
+		munmap((void*)mapped.net, sizeof(NnueNetwork));
+#endif
+	}
+
+	// Maps the whole file read-only; net is nullptr when it is missing or has the wrong size
+	MappedNetwork Map(const std::string& path)
+	{
+		MappedNetwork mapped = {};
+
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return mapped;
+		}
+
+		LARGE_INTEGER size;
+		HANDLE mapping = nullptr;
+
+		if (GetFileSizeEx(file, &size) && size.QuadPart == (LONGLONG)sizeof(NnueNetwork))
+		{
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		}
+
+		// The mapping stays valid after the file handle is closed
+		CloseHandle(file);
+
+		if (!mapping)
+		{
+			return mapped;
+		}
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+		if (!view)
+		{
+			CloseHandle(mapping);
+			return mapped;
+		}
+
+		mapped.net = (const NnueNetwork*)view;
+		mapped.handle = mapping;
+#else
+		int fd = open(path.c_str(), O_RDONLY);
+
+		if (fd < 0)
+		{
+			return mapped;
+		}
+
+		struct stat info;
+		void* view = MAP_FAILED;
+
+		if (fstat(fd, &info) == 0 && info.st_size == (off_t)sizeof(NnueNetwork))
+		{
+			view = mmap(nullptr, sizeof(NnueNetwork), PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+
+		// The mapping stays valid after the descriptor is closed
+		close(fd);
+
+		if (view != MAP_FAILED)
+		{
+			mapped.net = (const NnueNetwork*)view;
+		}
+#endif
+
+		return mapped;
+	}
+
+	bool ValidHeader(const NnueNetwork::Header& header)
+	{
+		return memcmp(header.magic, NNUE_MAGIC, sizeof(NNUE_MAGIC)) == 0 && header.version == NNUE_VERSION
+			&& header.inputs == NNUE_INPUTS && header.hidden == NNUE_HIDDEN && header.l1 == NNUE_L1
+			&& header.l2 == NNUE_L2;
+	}
+
+	// Each side sees the board from its own first rank
+	int Orient(Color perspective, int sq)
+	{
+		return perspective == Color::White ? sq : sq ^ 56;
+	}
+
+	// Weights of a piece as seen from one side, whose king stands on kingSq
+	const int16_t* FeatureRow(const NnueNetwork& net, Color perspective, int kingSq, Piece piece, Color color, int sq)
+	{
+		int type = PIECE_FEATURE[piece] * 2 + (color != perspective);
+		int index = Orient(perspective, kingSq) * 640 + type * NUM_SQUARES + Orient(perspective, sq);
+		return net.featureWeights[index];
+	}
+
+	uint8_t Clip(int value)
+	{
+		return (uint8_t)(value < 0 ? 0 : value > 127 ? 127 : value);
+	}
+}
+
+Nnue::Nnue(const NnueNetwork* network, void* mapping, SimdLevel level) : net(network), handle(mapping),
+	simd(SelectKernels(level))
+{
+}
+
+Nnue::~Nnue()
+{
+	Unmap({ net, handle });
+}
+
+std::shared_ptr<const Nnue> LoadNnue(const std::string& path, SimdLevel level)
+{
+	MappedNetwork mapped = Map(path);
+
+	if (!mapped.net)
+	{
+		return nullptr;
+	}
+
+	if (!ValidHeader(mapped.net->header))
+	{
+		Unmap(mapped);
+		return nullptr;
+	}
+
+	return std::make_shared<const Nnue>(mapped.net, mapped.handle, level);
+}
+
+void AccumulatorStack::reset(const Position& pos, const Nnue& network)
+{
+	nnue = &network;
+	size = 1;
+	stack[0].dirty.count = 0;
+
+	refresh(pos, Color::White, stack[0]);
+	refresh(pos, Color::Black, stack[0]);
+}
+
+void AccumulatorStack::push(const Position& pos, Move move)
+{
+	Accumulator& next = stack[size++];
+	DirtyPiece& dirty = next.dirty;
+	int from = FromSquare(move);
+	int to = ToSquare(move);
+	Piece piece = pos.pieceOn(from);
+	Color us = pos.sideToMove();
+	Color them = Opponent(us);
+
+	next.computed[Color::White] = next.computed[Color::Black] = false;
+	dirty.kingMoved[Color::White] = dirty.kingMoved[Color::Black] = false;
+	dirty.kingMoved[us] = piece == Piece::King;
+	dirty.count = 0;
+
+	auto add = [&dirty](Piece p, Color c, int f, int t)
+	{
+		dirty.piece[dirty.count] = p;
+		dirty.color[dirty.count] = c;
+		dirty.from[dirty.count] = f;
+		dirty.to[dirty.count] = t;
+		dirty.count++;
+	};
+
+	if (IsCastle(move))
+	{
+		int rookFrom, rookTo;
+		CastlingRookSquares(move, rookFrom, rookTo);
+		add(Piece::Rook, us, rookFrom, rookTo);
+		return;
+	}
+
+	if (IsCapture(move))
+	{
+		int capSq = MoveFlags(move) == EnPassant ? to ^ 8 : to;
+		add(pos.pieceOn(capSq), them, capSq, NO_SQUARE);
+	}
+
+	if (IsPromotion(move))
+	{
+		add(Piece::Pawn, us, from, NO_SQUARE);
+		add(PromotionPiece(move), us, NO_SQUARE, to);
+	}
+	else if (piece != Piece::King)
+	{
+		add(piece, us, from, to);
+	}
+}
+
+void AccumulatorStack::pushNull()
+{
+	Accumulator& next = stack[size++];
+
+	next.computed[Color::White] = next.computed[Color::Black] = false;
+	next.dirty.kingMoved[Color::White] = next.dirty.kingMoved[Color::Black] = false;
+	next.dirty.count = 0;
+}
+
+const Accumulator& AccumulatorStack::current(const Position& pos)
+{
+	update(pos, Color::White);
+	update(pos, Color::Black);
+
+	return stack[size - 1];
+}
+
+void AccumulatorStack::update(const Position& pos, Color perspective)
+{
+	if (stack[size - 1].computed[perspective])
+	{
+		return;
+	}
+
+	// Walk up the line to the last computed half; a move of this side's king in between moves
+	// every feature, so then it is cheaper to start over from the pieces on the board
+	int i = size - 1;
+
+	while (!stack[i].computed[perspective] && !stack[i].dirty.kingMoved[perspective])
+	{
+		i--;
+	}
+
+	if (!stack[i].computed[perspective])
+	{
+		refresh(pos, perspective, stack[size - 1]);
+		return;
+	}
+
+	// The king has not moved since, so the current square holds for every step
+	int kingSq = pos.kingSquare(perspective);
+
+	for (i++; i < size; i++)
+	{
+		const DirtyPiece& dirty = stack[i].dirty;
+		const int16_t* added[3];
+		const int16_t* removed[3];
+		int addedCount = 0;
+		int removedCount = 0;
+
+		for (int k = 0; k < dirty.count; k++)
+		{
+			if (dirty.from[k] != NO_SQUARE)
+			{
+				removed[removedCount++] = FeatureRow(nnue->weights(), perspective, kingSq, dirty.piece[k], dirty.color[k], dirty.from[k]);
+			}
+
+			if (dirty.to[k] != NO_SQUARE)
+			{
+				added[addedCount++] = FeatureRow(nnue->weights(), perspective, kingSq, dirty.piece[k], dirty.color[k], dirty.to[k]);
+			}
+		}
+
+		nnue->kernels().accumulatorUpdate(stack[i].values[perspective], stack[i - 1].values[perspective], added, addedCount,
+			removed, removedCount, NNUE_HIDDEN);
+		stack[i].computed[perspective] = true;
+	}
+}
+
+void AccumulatorStack::refresh(const Position& pos, Color perspective, Accumulator& accumulator)
+{
+	const int16_t* added[32];
+	int addedCount = 0;
+	int kingSq = pos.kingSquare(perspective);
+	Bitboard pieces = pos.occupied() & ~pos.pieces(Piece::King);
+
+	while (pieces)
+	{
+		int sq = PopLsb(pieces);
+		added[addedCount++] = FeatureRow(nnue->weights(), perspective, kingSq, pos.pieceOn(sq), pos.colorOn(sq), sq);
+	}
+
+	nnue->kernels().accumulatorUpdate(accumulator.values[perspective], nnue->weights().featureBiases, added,
+		addedCount, nullptr, 0, NNUE_HIDDEN);
+	accumulator.computed[perspective] = true;
+}
+
+int NnueEvaluate(const Position& pos, AccumulatorStack& accumulators)
+{
+	const Accumulator& accumulator = accumulators.current(pos);
+	const NnueNetwork& net = accumulators.network().weights();
+	const NnueKernels& kernels = accumulators.network().kernels();
+	Color us = pos.sideToMove();
+	Color them = Opponent(us);
+
+	alignas(64) uint8_t input[2 * NNUE_HIDDEN];
+	alignas(64) int32_t sums[NNUE_L1];
+	alignas(64) uint8_t hidden1[NNUE_L1];
+	alignas(64) uint8_t hidden2[NNUE_L2];
+
+	for (int i = 0; i < NNUE_HIDDEN; i++)
+	{
+		input[i] = Clip(accumulator.values[us][i]);
+		input[NNUE_HIDDEN + i] = Clip(accumulator.values[them][i]);
+	}
+
+	kernels.affineTransform(sums, input, net.hidden1Weights[0], net.hidden1Biases, 2 * NNUE_HIDDEN, NNUE_L1);
+
+	for (int i = 0; i < NNUE_L1; i++)
+	{
+		hidden1[i] = Clip(sums[i] >> 6);
+	}
+
+	kernels.affineTransform(sums, hidden1, net.hidden2Weights[0], net.hidden2Biases, NNUE_L1, NNUE_L2);
+
+	for (int i = 0; i < NNUE_L2; i++)
+	{
+		hidden2[i] = Clip(sums[i] >> 6);
+	}
+
+	int output = net.outputBias;
+
+	for (int i = 0; i < NNUE_L2; i++)
+	{
+		output += hidden2[i] * net.outputWeights[i];
+	}
+
+	output /= 16;
+
+	return output > MAX_EVAL ? MAX_EVAL : output < -MAX_EVAL ? -MAX_EVAL : output;
+}
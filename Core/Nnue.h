@@ -0,0 +1,133 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Move.h"
+#include "NnueKernels.h"
+#include "Position.h"
+
+// HalfKP network: every non-king piece is a feature relative to the square of each king, so the
+// 40960 inputs feed two 256-wide halves, one seen from each side. They go through two hidden
+// layers of 32 to a single output.
+constexpr int NNUE_INPUTS = NUM_SQUARES * 640;
+constexpr int NNUE_HIDDEN = 256;
+constexpr int NNUE_L1 = 32;
+constexpr int NNUE_L2 = 32;
+
+constexpr char NNUE_MAGIC[8] = { 'S', 'B', 'T', 'N', 'N', 'U', 'E', 0 };
+constexpr uint32_t NNUE_VERSION = 1;
+
+// Layout of a network file, byte for byte: the file is mapped and used in place, so it must be
+// exactly sizeof(NnueNetwork) bytes, little endian, each block starting on a 64-byte boundary.
+//
+// The accumulator is featureBiases plus the featureWeights rows of the active features, in int16.
+// Both halves are clipped to 0..127 and fed to the hidden layers side to move first. Each hidden
+// layer sums int8 weights times its uint8 inputs into int32, then divides by 64 and clips to
+// 0..127 again. The output divided by 16 is the score in centipawns.
+struct NnueNetwork
+{
+	struct alignas(64) Header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t inputs;
+		uint32_t hidden;
+		uint32_t l1;
+		uint32_t l2;
+	};
+
+	Header header;
+	alignas(64) int16_t featureBiases[NNUE_HIDDEN];
+	alignas(64) int16_t featureWeights[NNUE_INPUTS][NNUE_HIDDEN];
+	alignas(64) int32_t hidden1Biases[NNUE_L1];
+	alignas(64) int8_t hidden1Weights[NNUE_L1][2 * NNUE_HIDDEN];
+	alignas(64) int32_t hidden2Biases[NNUE_L2];
+	alignas(64) int8_t hidden2Weights[NNUE_L2][NNUE_L1];
+	alignas(64) int32_t outputBias;
+	alignas(64) int8_t outputWeights[NNUE_L2];
+};
+
+// A mapped network file and the kernels picked for it. Nothing in it changes after loading, so any
+// number of searches on any threads may share one; the file stays mapped until the last of them
+// lets go of it.
+class Nnue
+{
+public:
+	// Takes over a mapping made by LoadNnue(); the handle is the file mapping object on Windows
+	Nnue(const NnueNetwork* network, void* mapping, SimdLevel level);
+	~Nnue();
+
+	Nnue(const Nnue&) = delete;
+	Nnue& operator=(const Nnue&) = delete;
+
+	const NnueNetwork& weights() const { return *net; }
+	const NnueKernels& kernels() const { return simd; }
+
+private:
+	const NnueNetwork* net;
+	void* handle;
+	NnueKernels simd;
+};
+
+// Maps the network file with the kernels of the given level, or the best below it the CPU runs.
+// Null when the file is missing or is not a network of this layout.
+std::shared_ptr<const Nnue> LoadNnue(const std::string& path, SimdLevel level = DetectSimdLevel());
+
+// Pieces a move adds, removes or displaces, other than the kings; NO_SQUARE on the side that does not exist
+struct DirtyPiece
+{
+	int count;
+	Piece piece[3];
+	Color color[3];
+	int from[3];
+	int to[3];
+	// Which kings moved; that side's half can only be rebuilt from scratch
+	bool kingMoved[NUM_COLORS];
+};
+
+// Both halves of the first layer after one move, indexed by the color they are seen from
+struct Accumulator
+{
+	alignas(64) int16_t values[NUM_COLORS][NNUE_HIDDEN];
+	bool computed[NUM_COLORS];
+	DirtyPiece dirty;
+};
+
+// One accumulator per move of the line being searched. Moves only record what they changed;
+// the halves are brought up to date when a position is evaluated, from the nearest one computed
+// further up the line, so positions that are cut off before their evaluation cost nothing.
+class AccumulatorStack
+{
+public:
+	// Starts a new line at the given position, computing its accumulator with the network, which
+	// must outlive the line
+	void reset(const Position& pos, const Nnue& network);
+	// Called before pos.make(move), with the position the move is played in
+	void push(const Position& pos, Move move);
+	void pushNull();
+	void pop() { size--; }
+
+	// The accumulator of the position at the top of the line, computed if it was not already
+	const Accumulator& current(const Position& pos);
+	// The network given to reset()
+	const Nnue& network() const { return *nnue; }
+
+private:
+	void update(const Position& pos, Color perspective);
+	void refresh(const Position& pos, Color perspective, Accumulator& accumulator);
+
+	static constexpr int CAPACITY = 256;
+
+	Accumulator stack[CAPACITY];
+	int size;
+	const Nnue* nnue;
+};
+
+// Score of the position in centipawns from the point of view of the side to move, with the
+// network of the stack. The stack must hold the line that led to pos.
+int NnueEvaluate(const Position& pos, AccumulatorStack& accumulators);
+
+#endif
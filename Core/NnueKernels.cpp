@@ -0,0 +1,280 @@
+#include "NnueKernels.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define NNUE_X86 1
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#define TARGET_AVX512
+#define TARGET_VNNI
+#else
+#include <cpuid.h>
+// Each kernel is compiled for its own instruction set and only called once the CPU is known to have it
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512bw")))
+#define TARGET_VNNI __attribute__((target("avx2,avx512f,avx512bw,avx512vnni")))
+#if !defined(__clang__)
+// GCC's own AVX-512 headers trip this warning once inlined
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#endif
+#endif
+
+namespace
+{
+	typedef void (*UpdateKernel)(int16_t*, const int16_t*, const int16_t* const*, int, const int16_t* const*, int, int);
+	typedef void (*AffineKernel)(int32_t*, const uint8_t*, const int8_t*, const int32_t*, int, int);
+
+	void UpdateScalar(int16_t* out, const int16_t* in, const int16_t* const* added, int addedCount,
+		const int16_t* const* removed, int removedCount, int size)
+	{
+		for (int i = 0; i < size; i++)
+		{
+			int value = in[i];
+
+			for (int a = 0; a < addedCount; a++)
+			{
+				value += added[a][i];
+			}
+
+			for (int r = 0; r < removedCount; r++)
+			{
+				value -= removed[r][i];
+			}
+
+			out[i] = (int16_t)value;
+		}
+	}
+
+	void AffineScalar(int32_t* out, const uint8_t* in, const int8_t* weights, const int32_t* biases, int inputs,
+		int outputs)
+	{
+		for (int o = 0; o < outputs; o++)
+		{
+			const int8_t* row = weights + o * inputs;
+			int32_t sum = biases[o];
+
+			for (int i = 0; i < inputs; i++)
+			{
+				sum += in[i] * row[i];
+			}
+
+			out[o] = sum;
+		}
+	}
+
+#if defined(NNUE_X86)
+	void Cpuid(int leaf, int regs[4])
+	{
+#if defined(_MSC_VER)
+		__cpuidex(regs, leaf, 0);
+#else
+		__cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+	}
+
+	// Register state the operating system saves on a context switch
+	uint64_t EnabledXState()
+	{
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		uint32_t eax, edx;
+		__asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((uint64_t)edx << 32) | eax;
+#endif
+	}
+
+	TARGET_AVX2 void UpdateAvx2(int16_t* out, const int16_t* in, const int16_t* const* added, int addedCount,
+		const int16_t* const* removed, int removedCount, int size)
+	{
+		for (int i = 0; i < size; i += 16)
+		{
+			__m256i value = _mm256_load_si256((const __m256i*)(in + i));
+
+			for (int a = 0; a < addedCount; a++)
+			{
+				value = _mm256_add_epi16(value, _mm256_load_si256((const __m256i*)(added[a] + i)));
+			}
+
+			for (int r = 0; r < removedCount; r++)
+			{
+				value = _mm256_sub_epi16(value, _mm256_load_si256((const __m256i*)(removed[r] + i)));
+			}
+
+			_mm256_store_si256((__m256i*)(out + i), value);
+		}
+	}
+
+	TARGET_AVX2 int HorizontalSum(__m256i sum)
+	{
+		__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+		half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+		half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+		return _mm_cvtsi128_si32(half);
+	}
+
+	// u8 x i8 products summed in pairs to i16, then in pairs again to i32. With inputs of at most 127
+	// the i16 step cannot saturate.
+	TARGET_AVX2 __m256i DotAvx2(__m256i sum, const uint8_t* in, const int8_t* row)
+	{
+		__m256i product = _mm256_maddubs_epi16(_mm256_load_si256((const __m256i*)in), _mm256_loadu_si256((const __m256i*)row));
+		return _mm256_add_epi32(sum, _mm256_madd_epi16(product, _mm256_set1_epi16(1)));
+	}
+
+	TARGET_AVX2 void AffineAvx2(int32_t* out, const uint8_t* in, const int8_t* weights, const int32_t* biases, int inputs,
+		int outputs)
+	{
+		for (int o = 0; o < outputs; o++)
+		{
+			const int8_t* row = weights + o * inputs;
+			__m256i sum = _mm256_setzero_si256();
+
+			for (int i = 0; i < inputs; i += 32)
+			{
+				sum = DotAvx2(sum, in + i, row + i);
+			}
+
+			out[o] = biases[o] + HorizontalSum(sum);
+		}
+	}
+
+	TARGET_AVX512 void UpdateAvx512(int16_t* out, const int16_t* in, const int16_t* const* added, int addedCount,
+		const int16_t* const* removed, int removedCount, int size)
+	{
+		for (int i = 0; i < size; i += 32)
+		{
+			__m512i value = _mm512_load_si512((const void*)(in + i));
+
+			for (int a = 0; a < addedCount; a++)
+			{
+				value = _mm512_add_epi16(value, _mm512_load_si512((const void*)(added[a] + i)));
+			}
+
+			for (int r = 0; r < removedCount; r++)
+			{
+				value = _mm512_sub_epi16(value, _mm512_load_si512((const void*)(removed[r] + i)));
+			}
+
+			_mm512_store_si512((void*)(out + i), value);
+		}
+	}
+
+	// Folds a 512-bit sum onto a 256-bit one before the final reduction
+	TARGET_AVX512 int HorizontalSum(__m512i sum, __m256i tail)
+	{
+		__m512i folded = _mm512_add_epi32(sum, _mm512_shuffle_i64x2(sum, sum, 0x4E));
+		return HorizontalSum(_mm256_add_epi32(_mm512_castsi512_si256(folded), tail));
+	}
+
+	// A layer narrower than 64 inputs, or its last 32, goes through the 256-bit path
+	TARGET_AVX512 void AffineAvx512(int32_t* out, const uint8_t* in, const int8_t* weights, const int32_t* biases,
+		int inputs, int outputs)
+	{
+		const __m512i ones = _mm512_set1_epi16(1);
+
+		for (int o = 0; o < outputs; o++)
+		{
+			const int8_t* row = weights + o * inputs;
+			__m512i sum = _mm512_setzero_si512();
+			int i = 0;
+
+			for (; i + 64 <= inputs; i += 64)
+			{
+				__m512i product = _mm512_maddubs_epi16(_mm512_load_si512((const void*)(in + i)), _mm512_loadu_si512((const void*)(row + i)));
+				sum = _mm512_add_epi32(sum, _mm512_madd_epi16(product, ones));
+			}
+
+			__m256i tail = _mm256_setzero_si256();
+
+			if (i < inputs)
+			{
+				tail = DotAvx2(tail, in + i, row + i);
+			}
+
+			out[o] = biases[o] + HorizontalSum(sum, tail);
+		}
+	}
+
+	// VNNI multiplies, pairs and accumulates the bytes in one instruction
+	TARGET_VNNI void AffineVnni(int32_t* out, const uint8_t* in, const int8_t* weights, const int32_t* biases,
+		int inputs, int outputs)
+	{
+		for (int o = 0; o < outputs; o++)
+		{
+			const int8_t* row = weights + o * inputs;
+			__m512i sum = _mm512_setzero_si512();
+			int i = 0;
+
+			for (; i + 64 <= inputs; i += 64)
+			{
+				sum = _mm512_dpbusd_epi32(sum, _mm512_load_si512((const void*)(in + i)), _mm512_loadu_si512((const void*)(row + i)));
+			}
+
+			__m256i tail = _mm256_setzero_si256();
+
+			if (i < inputs)
+			{
+				tail = DotAvx2(tail, in + i, row + i);
+			}
+
+			out[o] = biases[o] + HorizontalSum(sum, tail);
+		}
+	}
+#endif
+}
+
+const char* SimdLevelName(SimdLevel simdLevel)
+{
+	const char* names[] = { "scalar", "AVX2", "AVX-512", "AVX-512 VNNI" };
+	return names[simdLevel];
+}
+
+SimdLevel DetectSimdLevel()
+{
+#if defined(NNUE_X86)
+	int regs[4] = { 0, 0, 0, 0 };
+
+	Cpuid(0, regs);
+
+	if (regs[0] < 7)
+	{
+		return SimdScalar;
+	}
+
+	Cpuid(1, regs);
+
+	// AVX state (XMM and YMM) must be enabled by the operating system, checked through OSXSAVE
+	if (!((regs[2] >> 27) & 1) || (EnabledXState() & 0x6) != 0x6)
+	{
+		return SimdScalar;
+	}
+
+	Cpuid(7, regs);
+
+	bool avx2 = (regs[1] >> 5) & 1;
+	bool avx512 = ((regs[1] >> 16) & 1) && ((regs[1] >> 30) & 1) && (EnabledXState() & 0xE0) == 0xE0;
+	bool vnni = (regs[2] >> 11) & 1;
+
+	return avx512 && vnni ? SimdVnni : avx512 ? SimdAvx512 : avx2 ? SimdAvx2 : SimdScalar;
+#else
+	return SimdScalar;
+#endif
+}
+
+NnueKernels SelectKernels(SimdLevel simdLevel)
+{
+	NnueKernels kernels = { simdLevel < DetectSimdLevel() ? simdLevel : DetectSimdLevel(), UpdateScalar, AffineScalar };
+
+#if defined(NNUE_X86)
+	const UpdateKernel updates[] = { UpdateScalar, UpdateAvx2, UpdateAvx512, UpdateAvx512 };
+	const AffineKernel affines[] = { AffineScalar, AffineAvx2, AffineAvx512, AffineVnni };
+
+	kernels.accumulatorUpdate = updates[kernels.level];
+	kernels.affineTransform = affines[kernels.level];
+#endif
+
+	return kernels;
+}
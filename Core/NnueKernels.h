@@ -0,0 +1,39 @@
+#ifndef NNUEKERNELS_H
+#define NNUEKERNELS_H
+
+#include <cstdint>
+
+// Instruction sets the network kernels are written for, slowest first
+enum SimdLevel
+{
+	SimdScalar,
+	SimdAvx2,
+	SimdAvx512,
+	SimdVnni
+};
+
+const char* SimdLevelName(SimdLevel level);
+// Best level both the CPU and the operating system support
+SimdLevel DetectSimdLevel();
+
+// The kernels of one instruction set. A plain value picked once per network, so searches on other
+// threads, possibly with other networks, never see it change.
+struct NnueKernels
+{
+	SimdLevel level;
+
+	// out = in + the added rows - the removed rows, over size int16 lanes with wrap-around like the
+	// hardware adds. size is a multiple of 32 and every pointer is 64-byte aligned.
+	void (*accumulatorUpdate)(int16_t* out, const int16_t* in, const int16_t* const* added, int addedCount,
+		const int16_t* const* removed, int removedCount, int size);
+
+	// out[o] = biases[o] + the dot product of in and row o of weights, for unsigned 8-bit inputs of
+	// at most 127 and signed 8-bit weights. inputs is a multiple of 32 and the rows are 32-byte aligned.
+	void (*affineTransform)(int32_t* out, const uint8_t* in, const int8_t* weights, const int32_t* biases,
+		int inputs, int outputs);
+};
+
+// The kernels of a level; a level above DetectSimdLevel() is lowered to it
+NnueKernels SelectKernels(SimdLevel level);
+
+#endif
@@ -0,0 +1,182 @@
+#include "Numa.h"
+
+#if defined(__linux__)
+#include <cctype>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+	// From linux/mempolicy.h
+	constexpr int MPOL_BIND_MODE = 2;
+	constexpr int MPOL_INTERLEAVE_MODE = 3;
+	constexpr unsigned MPOL_MF_MOVE_FLAG = 1 << 1;
+	constexpr int MAX_NODES = 1024;
+	constexpr int MASK_BITS = 8 * sizeof(unsigned long);
+
+	// Parses sysfs cpu lists such as "0-15,32-47"
+	std::vector<int> ParseCpuList(const std::string& list)
+	{
+		std::vector<int> cpus;
+		size_t i = 0;
+
+		while (i < list.size())
+		{
+			size_t end = list.find(',', i);
+			std::string range = list.substr(i, end == std::string::npos ? std::string::npos : end - i);
+			size_t dash = range.find('-');
+
+			if (!range.empty() && isdigit((unsigned char)range[0]))
+			{
+				int first = std::stoi(range);
+				int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+
+				for (int cpu = first; cpu <= last; cpu++)
+				{
+					cpus.push_back(cpu);
+				}
+			}
+
+			if (end == std::string::npos)
+			{
+				break;
+			}
+
+			i = end + 1;
+		}
+
+		return cpus;
+	}
+
+	// Cores of every node, read once
+	const std::vector<std::vector<int>>& Topology()
+	{
+		static const std::vector<std::vector<int>> nodes = []()
+		{
+			std::vector<std::vector<int>> result;
+
+			for (int node = 0; node < MAX_NODES; node++)
+			{
+				std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+				std::string list;
+
+				if (!file || !std::getline(file, list))
+				{
+					break;
+				}
+
+				result.push_back(ParseCpuList(list));
+			}
+
+			return result;
+		}();
+
+		return nodes;
+	}
+
+	bool SetPolicy(void* memory, size_t size, int mode, const unsigned long* mask, unsigned flags)
+	{
+		return syscall(SYS_mbind, memory, size, mode, mask, (unsigned long)MAX_NODES, flags) == 0;
+	}
+}
+
+int NumaNodeCount()
+{
+	return Topology().empty() ? 1 : (int)Topology().size();
+}
+
+int NumaNodeForThread(int threadIndex)
+{
+	const std::vector<std::vector<int>>& nodes = Topology();
+	int cores = 0;
+
+	for (const std::vector<int>& cpus : nodes)
+	{
+		cores += (int)cpus.size();
+	}
+
+	if (cores == 0)
+	{
+		return 0;
+	}
+
+	int slot = threadIndex % cores;
+
+	for (int node = 0; node < (int)nodes.size(); node++)
+	{
+		if (slot < (int)nodes[node].size())
+		{
+			return node;
+		}
+
+		slot -= (int)nodes[node].size();
+	}
+
+	return 0;
+}
+
+bool BindThreadToNode(int node)
+{
+	if (node < 0 || node >= (int)Topology().size() || Topology()[node].empty())
+	{
+		return false;
+	}
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+
+	for (int cpu : Topology()[node])
+	{
+		CPU_SET(cpu, &set);
+	}
+
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+bool BindMemoryToNode(void* memory, size_t size, int node)
+{
+	if (node < 0 || node >= MAX_NODES || NumaNodeCount() < 2)
+	{
+		return false;
+	}
+
+	unsigned long mask[MAX_NODES / MASK_BITS] = {};
+	mask[node / MASK_BITS] = 1UL << (node % MASK_BITS);
+
+	return SetPolicy(memory, size, MPOL_BIND_MODE, mask, MPOL_MF_MOVE_FLAG);
+}
+
+bool InterleaveMemory(void* memory, size_t size)
+{
+	int count = NumaNodeCount();
+
+	if (count < 2)
+	{
+		return false;
+	}
+
+	unsigned long mask[MAX_NODES / MASK_BITS] = {};
+
+	for (int node = 0; node < count; node++)
+	{
+		mask[node / MASK_BITS] |= 1UL << (node % MASK_BITS);
+	}
+
+	return SetPolicy(memory, size, MPOL_INTERLEAVE_MODE, mask, 0);
+}
+
+#else
+
+int NumaNodeCount() { return 1; }
+int NumaNodeForThread(int) { return 0; }
+bool BindThreadToNode(int) { return false; }
+bool BindMemoryToNode(void*, size_t, int) { return false; }
+bool InterleaveMemory(void*, size_t) { return false; }
+
+#endif
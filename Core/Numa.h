@@ -0,0 +1,24 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <cstddef>
+
+// NUMA placement for the search threads and their memory. Linux only: the topology is read from
+// sysfs and applied with the affinity and mbind system calls, without linking libnuma. Elsewhere
+// the machine is a single node and every call is a no-op that returns false.
+
+int NumaNodeCount();
+
+// Node for the thread with this index; threads fill the nodes in proportion to their cores
+int NumaNodeForThread(int threadIndex);
+
+// Restricts the calling thread to the cores of the node
+bool BindThreadToNode(int node);
+
+// Places the pages of a page-aligned block on one node, moving any that already exist
+bool BindMemoryToNode(void* memory, size_t size, int node);
+
+// Spreads the pages of a block round robin over all nodes as they are first touched
+bool InterleaveMemory(void* memory, size_t size);
+
+#endif
@@ -0,0 +1,98 @@
+#include "Pawns.h"
+
+namespace
+{
+	const Score DOUBLED = { 10, 25 };
+	const Score ISOLATED = { 8, 15 };
+	const Score BACKWARD = { 8, 12 };
+	// By rank counted from the pawn's own side
+	const Score PASSED[8] = { { 0, 0 }, { 5, 10 }, { 10, 17 }, { 12, 25 }, { 25, 45 }, { 45, 80 }, { 80, 130 }, { 0, 0 } };
+
+	template<Color C>
+	Bitboard PawnAttacksOf(Bitboard pawns)
+	{
+		return C == Color::White
+			? ((pawns & ~FILE_A_BB) << 7) | ((pawns & ~FILE_H_BB) << 9)
+			: ((pawns & ~FILE_A_BB) >> 9) | ((pawns & ~FILE_H_BB) >> 7);
+	}
+
+	// Ranks strictly in front of a pawn of color C on sq; pawns never stand on the last rank
+	template<Color C>
+	Bitboard RanksAhead(int sq)
+	{
+		return C == Color::White ? ~0ULL << (8 * (RankOf(sq) + 1)) : (1ULL << (8 * RankOf(sq))) - 1;
+	}
+
+	Bitboard AdjacentFiles(int sq)
+	{
+		Bitboard file = FILE_A_BB << FileOf(sq);
+		return ((file & ~FILE_H_BB) << 1) | ((file & ~FILE_A_BB) >> 1);
+	}
+
+	void Add(Score& score, const Score& term, int sign)
+	{
+		score.mg += sign * term.mg;
+		score.eg += sign * term.eg;
+	}
+
+	template<Color Us>
+	Score EvaluatePawns(const Position& pos)
+	{
+		constexpr Color Them = Us == Color::White ? Color::Black : Color::White;
+
+		Score score = { 0, 0 };
+		Bitboard ours = pos.pieces(Us, Piece::Pawn);
+		Bitboard theirs = pos.pieces(Them, Piece::Pawn);
+
+		for (Bitboard b = ours; b; )
+		{
+			int sq = PopLsb(b);
+			Bitboard file = FILE_A_BB << FileOf(sq);
+			Bitboard adjacent = AdjacentFiles(sq);
+			Bitboard ahead = RanksAhead<Us>(sq);
+			int stop = Us == Color::White ? sq + 8 : sq - 8;
+
+			// Only the rear pawn of a doubled pair is penalised
+			if (ours & file & ahead)
+			{
+				Add(score, DOUBLED, -1);
+			}
+
+			if (!(theirs & (file | adjacent) & ahead))
+			{
+				Add(score, PASSED[Us == Color::White ? RankOf(sq) : 7 - RankOf(sq)], 1);
+			}
+
+			if (!(ours & adjacent))
+			{
+				Add(score, ISOLATED, -1);
+			}
+			// No neighbour level or behind to support its advance, and an enemy pawn guards the way
+			else if (!(ours & adjacent & ~ahead) && (PawnAttacks(Us, stop) & theirs))
+			{
+				Add(score, BACKWARD, -1);
+			}
+		}
+
+		return score;
+	}
+}
+
+const PawnEntry& ProbePawns(const Position& pos, PawnTable& table)
+{
+	bool hit;
+	PawnEntry& entry = table.probe(pos.pawnKey(), hit);
+
+	if (!hit)
+	{
+		Score white = EvaluatePawns<Color::White>(pos);
+		Score black = EvaluatePawns<Color::Black>(pos);
+
+		entry.key = pos.pawnKey();
+		entry.score = { white.mg - black.mg, white.eg - black.eg };
+		entry.attacks[Color::White] = PawnAttacksOf<Color::White>(pos.pieces(Color::White, Piece::Pawn));
+		entry.attacks[Color::Black] = PawnAttacksOf<Color::Black>(pos.pieces(Color::Black, Piece::Pawn));
+	}
+
+	return entry;
+}
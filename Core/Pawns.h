@@ -0,0 +1,22 @@
+#ifndef PAWNS_H
+#define PAWNS_H
+
+#include "HashTable.h"
+#include "Position.h"
+
+// Pawn structure terms, which only change when a pawn moves or is taken
+struct PawnEntry
+{
+	uint64_t key;
+	// Passed, doubled, isolated and backward pawns, from White's point of view
+	Score score;
+	// Squares attacked by the pawns of each color
+	Bitboard attacks[NUM_COLORS];
+};
+
+typedef HashTable<PawnEntry, 16384> PawnTable;
+
+// The entry of the pawns of pos, computed on a miss
+const PawnEntry& ProbePawns(const Position& pos, PawnTable& table);
+
+#endif
@@ -0,0 +1,99 @@
+#include "Perft.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MoveList.h"
+
+uint64_t Perft(Position& pos, int depth)
+{
+	MoveList moves(pos);
+
+	if (depth <= 1)
+	{
+		return depth == 1 ? (uint64_t)moves.size() : 1;
+	}
+
+	uint64_t nodes = 0;
+
+	for (Move move : moves)
+	{
+		pos.make(move);
+		nodes += Perft(pos, depth - 1);
+		pos.unmake(move);
+	}
+
+	return nodes;
+}
+
+PerftResult RunPerft(const Position& pos, int depth, int threads, bool divide)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	MoveList moves(pos);
+	int count = moves.size();
+
+	std::atomic<int> next(0);
+	std::atomic<uint64_t> total(0);
+	std::mutex printLock;
+
+	// Workers take the next unclaimed root move until none are left
+	auto work = [&]()
+	{
+		Position local = pos;
+
+		for (int i = next++; i < count; i = next++)
+		{
+			local.make(moves[i]);
+			uint64_t nodes = Perft(local, depth - 1);
+			local.unmake(moves[i]);
+
+			total += nodes;
+
+			if (divide)
+			{
+				std::lock_guard<std::mutex> lock(printLock);
+				printf("%s: %llu\n", MoveToString(moves[i]).c_str(), (unsigned long long)nodes);
+			}
+		}
+	};
+
+	if (depth <= 0)
+	{
+		total = 1;
+	}
+	else if (depth == 1)
+	{
+		for (int i = 0; i < count && divide; i++)
+		{
+			printf("%s: 1\n", MoveToString(moves[i]).c_str());
+		}
+
+		total = count;
+	}
+	else
+	{
+		std::vector<std::thread> pool;
+
+		for (int t = 1; t < threads && t < count; t++)
+		{
+			pool.emplace_back(work);
+		}
+
+		work();
+
+		for (std::thread& thread : pool)
+		{
+			thread.join();
+		}
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	PerftResult result = { total, elapsed.count() };
+
+	return result;
+}
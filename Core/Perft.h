@@ -0,0 +1,22 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <cstdint>
+
+#include "Position.h"
+
+// Leaf nodes of the legal move tree at the given depth. The last ply is bulk counted: the
+// number of legal moves is added without playing them.
+uint64_t Perft(Position& pos, int depth);
+
+struct PerftResult
+{
+	uint64_t nodes;
+	double seconds;
+};
+
+// Splits the root moves across a pool of threads, each working on its own copy of the position.
+// With divide set, prints the node count below every root move as it finishes.
+PerftResult RunPerft(const Position& pos, int depth, int threads, bool divide);
+
+#endif
@@ -1,9 +1,15 @@
+#ifndef PIECE_H
+#define PIECE_H
+
 enum Piece
 {
+	NoPiece = 0,
 	King = 1,
 	Queen = 2,
 	Bishop = 3,
 	Knight = 4,
 	Rook = 5,
 	Pawn = 6
-};
\ No newline at end of file
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,797 @@
+#include "Position.h"
+
+#include <cctype>
+#include <sstream>
+
+namespace
+{
+	// Castling rights that survive a move touching each square
+	struct CastlingMask
+	{
+		int squares[NUM_SQUARES];
+	};
+
+	constexpr CastlingMask MakeCastlingMask()
+	{
+		CastlingMask mask = {};
+
+		for (int sq = 0; sq < NUM_SQUARES; sq++)
+		{
+			mask.squares[sq] = AllCastling;
+		}
+
+		mask.squares[MakeSquare(4, 0)] &= ~(WhiteKingSide | WhiteQueenSide);
+		mask.squares[MakeSquare(7, 0)] &= ~WhiteKingSide;
+		mask.squares[MakeSquare(0, 0)] &= ~WhiteQueenSide;
+		mask.squares[MakeSquare(4, 7)] &= ~(BlackKingSide | BlackQueenSide);
+		mask.squares[MakeSquare(7, 7)] &= ~BlackKingSide;
+		mask.squares[MakeSquare(0, 7)] &= ~BlackQueenSide;
+
+		return mask;
+	}
+
+	constexpr CastlingMask CASTLING_MASK = MakeCastlingMask();
+
+	struct ZobristKeys
+	{
+		uint64_t pieceSquare[NUM_COLORS][NUM_PIECE_TYPES][NUM_SQUARES];
+		uint64_t castling[16];
+		uint64_t epFile[8];
+		uint64_t side;
+		// Pawn key of a position without pawns, so it never matches an empty table slot
+		uint64_t noPawns;
+	};
+
+	// splitmix64, stepped at compile time so the keys are fixed constants
+	constexpr uint64_t NextRandom(uint64_t& state)
+	{
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	constexpr ZobristKeys MakeZobristKeys()
+	{
+		ZobristKeys keys = {};
+		uint64_t state = 0x5AB3E7007ULL;
+
+		for (int color = Color::Black; color <= Color::White; color++)
+		{
+			for (int piece = Piece::King; piece <= Piece::Pawn; piece++)
+			{
+				for (int sq = 0; sq < NUM_SQUARES; sq++)
+				{
+					keys.pieceSquare[color][piece][sq] = NextRandom(state);
+				}
+			}
+		}
+
+		// Combined rights hash as the XOR of the single rights, so losing one right is one XOR
+		uint64_t rights[4] = { NextRandom(state), NextRandom(state), NextRandom(state), NextRandom(state) };
+
+		for (int mask = 0; mask < 16; mask++)
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				if (mask & (1 << i))
+				{
+					keys.castling[mask] ^= rights[i];
+				}
+			}
+		}
+
+		for (int file = 0; file < 8; file++)
+		{
+			keys.epFile[file] = NextRandom(state);
+		}
+
+		keys.side = NextRandom(state);
+		keys.noPawns = NextRandom(state);
+
+		return keys;
+	}
+
+	constexpr ZobristKeys ZOBRIST = MakeZobristKeys();
+
+	// Material and piece-square values by Piece (PeSTO's tables). Each table is written the way the board
+	// is printed, rank 8 first, so White's square sq reads entry sq ^ 56 and Black's reads sq.
+	constexpr int MG_VALUE[NUM_PIECE_TYPES] = { 0, 0, 1025, 365, 337, 477, 82 };
+	constexpr int EG_VALUE[NUM_PIECE_TYPES] = { 0, 0, 936, 297, 281, 512, 94 };
+	constexpr int PHASE_WEIGHT[NUM_PIECE_TYPES] = { 0, 0, 4, 1, 1, 2, 0 };
+
+	constexpr int MG_TABLE[NUM_PIECE_TYPES][NUM_SQUARES] =
+	{
+		{ 0 },
+		{ // King
+			-65,  23,  16, -15, -56, -34,   2,  13,
+			 29,  -1, -20,  -7,  -8,  -4, -38, -29,
+			 -9,  24,   2, -16, -20,   6,  22, -22,
+			-17, -20, -12, -27, -30, -25, -14, -36,
+			-49,  -1, -27, -39, -46, -44, -33, -51,
+			-14, -14, -22, -46, -44, -30, -15, -27,
+			  1,   7,  -8, -64, -43, -16,   9,   8,
+			-15,  36,  12, -54,   8, -28,  24,  14
+		},
+		{ // Queen
+			-28,   0,  29,  12,  59,  44,  43,  45,
+			-24, -39,  -5,   1, -16,  57,  28,  54,
+			-13, -17,   7,   8,  29,  56,  47,  57,
+			-27, -27, -16, -16,  -1,  17,  -2,   1,
+			 -9, -26,  -9, -10,  -2,  -4,   3,  -3,
+			-14,   2, -11,  -2,  -5,   2,  14,   5,
+			-35,  -8,  11,   2,   8,  15,  -3,   1,
+			 -1, -18,  -9,  10, -15, -25, -31, -50
+		},
+		{ // Bishop
+			-29,   4, -82, -37, -25, -42,   7,  -8,
+			-26,  16, -18, -13,  30,  59,  18, -47,
+			-16,  37,  43,  40,  35,  50,  37,  -2,
+			 -4,   5,  19,  50,  37,  37,   7,  -2,
+			 -6,  13,  13,  26,  34,  12,  10,   4,
+			  0,  15,  15,  15,  14,  27,  18,  10,
+			  4,  15,  16,   0,   7,  21,  33,   1,
+			-33,  -3, -14, -21, -13, -12, -39, -21
+		},
+		{ // Knight
+			-167, -89, -34, -49,  61, -97, -15,-107,
+			 -73, -41,  72,  36,  23,  62,   7, -17,
+			 -47,  60,  37,  65,  84, 129,  73,  44,
+			  -9,  17,  19,  53,  37,  69,  18,  22,
+			 -13,   4,  16,  13,  28,  19,  21,  -8,
+			 -23,  -9,  12,  10,  19,  17,  25, -16,
+			 -29, -53, -12,  -3,  -1,  18, -14, -19,
+			-105, -21, -58, -33, -17, -28, -19, -23
+		},
+		{ // Rook
+			 32,  42,  32,  51,  63,   9,  31,  43,
+			 27,  32,  58,  62,  80,  67,  26,  44,
+			 -5,  19,  26,  36,  17,  45,  61,  16,
+			-24, -11,   7,  26,  24,  35,  -8, -20,
+			-36, -26, -12,  -1,   9,  -7,   6, -23,
+			-45, -25, -16, -17,   3,   0,  -5, -33,
+			-44, -16, -20,  -9,  -1,  11,  -6, -71,
+			-19, -13,   1,  17,  16,   7, -37, -26
+		},
+		{ // Pawn
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			 98, 134,  61,  95,  68, 126,  34, -11,
+			 -6,   7,  26,  31,  65,  56,  25, -20,
+			-14,  13,   6,  21,  23,  12,  17, -23,
+			-27,  -2,  -5,  12,  17,   6,  10, -25,
+			-26,  -4,  -4, -10,   3,   3,  33, -12,
+			-35,  -1, -20, -23, -15,  24,  38, -22,
+			  0,   0,   0,   0,   0,   0,   0,   0
+		}
+	};
+
+	constexpr int EG_TABLE[NUM_PIECE_TYPES][NUM_SQUARES] =
+	{
+		{ 0 },
+		{ // King
+			-74, -35, -18, -18, -11,  15,   4, -17,
+			-12,  17,  14,  17,  17,  38,  23,  11,
+			 10,  17,  23,  15,  20,  45,  44,  13,
+			 -8,  22,  24,  27,  26,  33,  26,   3,
+			-18,  -4,  21,  24,  27,  23,   9, -11,
+			-19,  -3,  11,  21,  23,  16,   7,  -9,
+			-27, -11,   4,  13,  14,   4,  -5, -17,
+			-53, -34, -21, -11, -28, -14, -24, -43
+		},
+		{ // Queen
+			 -9,  22,  22,  27,  27,  19,  10,  20,
+			-17,  20,  32,  41,  58,  25,  30,   0,
+			-20,   6,   9,  49,  47,  35,  19,   9,
+			  3,  22,  24,  45,  57,  40,  57,  36,
+			-18,  28,  19,  47,  31,  34,  39,  23,
+			-16, -27,  15,   6,   9,  17,  10,   5,
+			-22, -23, -30, -16, -16, -23, -36, -32,
+			-33, -28, -22, -43,  -5, -32, -20, -41
+		},
+		{ // Bishop
+			-14, -21, -11,  -8,  -7,  -9, -17, -24,
+			 -8,  -4,   7, -12,  -3, -13,  -4, -14,
+			  2,  -8,   0,  -1,  -2,   6,   0,   4,
+			 -3,   9,  12,   9,  14,  10,   3,   2,
+			 -6,   3,  13,  19,   7,  10,  -3,  -9,
+			-12,  -3,   8,  10,  13,   3,  -7, -15,
+			-14, -18,  -7,  -1,   4,  -9, -15, -27,
+			-23,  -9, -23,  -5,  -9, -16,  -5, -17
+		},
+		{ // Knight
+			 -58, -38, -13, -28, -31, -27, -63, -99,
+			 -25,  -8, -25,  -2,  -9, -25, -24, -52,
+			 -24, -20,  10,   9,  -1,  -9, -19, -41,
+			 -17,   3,  22,  22,  22,  11,   8, -18,
+			 -18,  -6,  16,  25,  16,  17,   4, -18,
+			 -23,  -3,  -1,  15,  10,  -3, -20, -22,
+			 -42, -20, -10,  -5,  -2, -20, -23, -44,
+			 -29, -51, -23, -15, -22, -18, -50, -64
+		},
+		{ // Rook
+			 13,  10,  18,  15,  12,  12,   8,   5,
+			 11,  13,  13,  11,  -3,   3,   8,   3,
+			  7,   7,   7,   5,   4,  -3,  -5,  -3,
+			  4,   3,  13,   1,   2,   1,  -1,   2,
+			  3,   5,   8,   4,  -5,  -6,  -8, -11,
+			 -4,   0,  -5,  -1,  -7, -12,  -8, -16,
+			 -6,  -6,   0,   2,  -9,  -9, -11,  -3,
+			 -9,   2,   3,  -1,  -5, -13,   4, -20
+		},
+		{ // Pawn
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			178, 173, 158, 134, 147, 132, 165, 187,
+			 94, 100,  85,  67,  56,  53,  82,  84,
+			 32,  24,  13,   5,  -2,   4,  17,  17,
+			 13,   9,  -3,  -7,  -7,  -8,   3,  -1,
+			  4,   7,  -6,   1,   0,  -5,  -1,  -8,
+			 13,   8,   8,  10,  13,   0,   2,  -7,
+			  0,   0,   0,   0,   0,   0,   0,   0
+		}
+	};
+
+	struct PieceSquareTable
+	{
+		Score scores[NUM_COLORS][NUM_PIECE_TYPES][NUM_SQUARES];
+	};
+
+	// Black's entries are negated, so the position keeps one score from White's point of view
+	constexpr PieceSquareTable MakePieceSquareTable()
+	{
+		PieceSquareTable table = {};
+
+		for (int piece = Piece::King; piece <= Piece::Pawn; piece++)
+		{
+			for (int sq = 0; sq < NUM_SQUARES; sq++)
+			{
+				table.scores[Color::White][piece][sq].mg = MG_VALUE[piece] + MG_TABLE[piece][sq ^ 56];
+				table.scores[Color::White][piece][sq].eg = EG_VALUE[piece] + EG_TABLE[piece][sq ^ 56];
+				table.scores[Color::Black][piece][sq].mg = -(MG_VALUE[piece] + MG_TABLE[piece][sq]);
+				table.scores[Color::Black][piece][sq].eg = -(EG_VALUE[piece] + EG_TABLE[piece][sq]);
+			}
+		}
+
+		return table;
+	}
+
+	constexpr PieceSquareTable PSQ = MakePieceSquareTable();
+}
+
+Position::Position() : history(RESERVED_GAME_PLIES)
+{
+	clear();
+}
+
+void Position::clear()
+{
+	for (int i = 0; i < NUM_PIECE_TYPES; i++)
+	{
+		byType[i] = 0;
+	}
+
+	for (int i = 0; i < NUM_COLORS; i++)
+	{
+		byColor[i] = 0;
+	}
+
+	for (int sq = 0; sq < NUM_SQUARES; sq++)
+	{
+		board[sq] = Piece::NoPiece;
+	}
+
+	side = Color::White;
+	castling = 0;
+	ep = NO_SQUARE;
+	fiftyMoveCounter = 0;
+	ply = 0;
+	historySize = 0;
+	zobristKey = 0;
+	checkersBB = 0;
+	psqScore = { 0, 0 };
+	phaseValue = 0;
+	pawnKeyValue = ZOBRIST.noPawns;
+	materialKeyValue = 0;
+}
+
+void Position::setStartPosition()
+{
+	const Piece backRank[8] = { Piece::Rook, Piece::Knight, Piece::Bishop, Piece::Queen, Piece::King, Piece::Bishop, Piece::Knight, Piece::Rook };
+
+	clear();
+
+	for (int file = 0; file < 8; file++)
+	{
+		put(backRank[file], Color::White, MakeSquare(file, 0));
+		put(Piece::Pawn, Color::White, MakeSquare(file, 1));
+		put(Piece::Pawn, Color::Black, MakeSquare(file, 6));
+		put(backRank[file], Color::Black, MakeSquare(file, 7));
+	}
+
+	castling = AllCastling;
+	computeKey();
+}
+
+bool Position::setFen(const std::string& fen)
+{
+	const std::string pieceChars = " kqbnrp";
+	std::istringstream stream(fen);
+	std::string placement, color, rights, epField;
+	int halfMoves = 0, fullMoves = 1;
+
+	clear();
+
+	if (!(stream >> placement >> color >> rights >> epField))
+	{
+		return false;
+	}
+
+	// Halfmove and fullmove counters are optional, EPD style
+	stream >> halfMoves >> fullMoves;
+
+	int file = 0, rank = 7;
+
+	for (char c : placement)
+	{
+		size_t piece = pieceChars.find((char)tolower(c));
+
+		if (c == '/')
+		{
+			file = 0;
+			rank--;
+		}
+		else if (c >= '1' && c <= '8')
+		{
+			file += c - '0';
+		}
+		else if (piece != std::string::npos && piece > 0 && file < 8 && rank >= 0)
+		{
+			put(Piece(piece), isupper(c) ? Color::White : Color::Black, MakeSquare(file, rank));
+			file++;
+		}
+		else
+		{
+			clear();
+			return false;
+		}
+	}
+
+	if (Popcount(pieces(Color::White, Piece::King)) != 1 || Popcount(pieces(Color::Black, Piece::King)) != 1
+		|| (color != "w" && color != "b"))
+	{
+		clear();
+		return false;
+	}
+
+	side = color == "w" ? Color::White : Color::Black;
+
+	const std::string rightChars = "KQkq";
+
+	for (char c : rights)
+	{
+		size_t right = rightChars.find(c);
+
+		if (right == std::string::npos && !(c == '-' && rights.size() == 1))
+		{
+			clear();
+			return false;
+		}
+
+		castling |= right == std::string::npos ? 0 : 1 << right;
+	}
+
+	// A right is only kept while its king and rook stand on their home squares, which is all that
+	// make() and the move generator were written for
+	const int rightSquares[4][2] = { { 4, 7 }, { 4, 0 }, { 60, 63 }, { 60, 56 } };
+
+	for (int i = 0; i < 4; i++)
+	{
+		Color owner = i < 2 ? Color::White : Color::Black;
+
+		if (!(pieces(owner, Piece::King) & SquareBB(rightSquares[i][0])) || !(pieces(owner, Piece::Rook) & SquareBB(rightSquares[i][1])))
+		{
+			castling &= ~(1 << i);
+		}
+	}
+
+	// Same rule as make(): only keep an en passant square a pawn can actually use
+	if (epField.size() == 2 && epField[0] >= 'a' && epField[0] <= 'h' && (epField[1] == '3' || epField[1] == '6'))
+	{
+		int sq = MakeSquare(epField[0] - 'a', epField[1] - '1');
+
+		if (PawnAttacks(Opponent(side), sq) & pieces(side, Piece::Pawn))
+		{
+			ep = sq;
+		}
+	}
+
+	checkersBB = attackersTo(kingSquare(side), occupied()) & pieces(Opponent(side));
+	fiftyMoveCounter = halfMoves;
+	ply = 2 * (fullMoves > 0 ? fullMoves - 1 : 0) + (side == Color::Black ? 1 : 0);
+	computeKey();
+
+	return true;
+}
+
+CheckInfo::CheckInfo(const Position& pos)
+{
+	Color us = pos.sideToMove();
+	Color them = Opponent(us);
+	Bitboard occupancy = pos.occupied();
+
+	kingSquare = pos.kingSquare(them);
+	discoverers = pos.pinned(them, us) & pos.pieces(us);
+
+	checkSquares[Piece::NoPiece] = 0;
+	checkSquares[Piece::King] = 0;
+	checkSquares[Piece::Pawn] = PawnAttacks(them, kingSquare);
+	checkSquares[Piece::Knight] = KnightAttacks(kingSquare);
+	checkSquares[Piece::Bishop] = BishopAttacks(kingSquare, occupancy);
+	checkSquares[Piece::Rook] = RookAttacks(kingSquare, occupancy);
+	checkSquares[Piece::Queen] = checkSquares[Piece::Bishop] | checkSquares[Piece::Rook];
+}
+
+Bitboard Position::attackersTo(int sq, Bitboard occupancy) const
+{
+	return (PawnAttacks(Color::White, sq) & pieces(Color::Black, Piece::Pawn))
+		| (PawnAttacks(Color::Black, sq) & pieces(Color::White, Piece::Pawn))
+		| (KnightAttacks(sq) & byType[Piece::Knight])
+		| (KingAttacks(sq) & byType[Piece::King])
+		| (RookAttacks(sq, occupancy) & (byType[Piece::Rook] | byType[Piece::Queen]))
+		| (BishopAttacks(sq, occupancy) & (byType[Piece::Bishop] | byType[Piece::Queen]));
+}
+
+Bitboard Position::pinned(Color king, Color by) const
+{
+	int ksq = kingSquare(king);
+	Bitboard result = 0;
+	Bitboard snipers = ((RookAttacks(ksq, 0) & (byType[Piece::Rook] | byType[Piece::Queen]))
+		| (BishopAttacks(ksq, 0) & (byType[Piece::Bishop] | byType[Piece::Queen]))) & pieces(by);
+
+	while (snipers)
+	{
+		Bitboard blockers = BetweenBB(ksq, PopLsb(snipers)) & occupied();
+
+		if (blockers && !(blockers & (blockers - 1)))
+		{
+			result |= blockers;
+		}
+	}
+
+	return result;
+}
+
+bool Position::givesCheck(Move move, const CheckInfo& info) const
+{
+	int from = FromSquare(move);
+	int to = ToSquare(move);
+	int ksq = info.kingSquare;
+	Bitboard occupancy = (occupied() ^ SquareBB(from)) | SquareBB(to);
+
+	if (!IsPromotion(move) && (info.checkSquares[board[from]] & SquareBB(to)))
+	{
+		return true;
+	}
+
+	// A piece leaving the line between a slider and the king
+	if ((info.discoverers & SquareBB(from)) && !(LineBB(from, ksq) & SquareBB(to)))
+	{
+		return true;
+	}
+
+	if (IsPromotion(move))
+	{
+		switch (PromotionPiece(move))
+		{
+		case Piece::Knight:
+			return (KnightAttacks(to) & SquareBB(ksq)) != 0;
+		case Piece::Bishop:
+			return (BishopAttacks(to, occupancy) & SquareBB(ksq)) != 0;
+		case Piece::Rook:
+			return (RookAttacks(to, occupancy) & SquareBB(ksq)) != 0;
+		default:
+			return (QueenAttacks(to, occupancy) & SquareBB(ksq)) != 0;
+		}
+	}
+
+	if (MoveFlags(move) == EnPassant)
+	{
+		// The captured pawn may have been the last blocker of a slider
+		occupancy ^= SquareBB(to ^ 8);
+
+		return (((RookAttacks(ksq, occupancy) & (byType[Piece::Rook] | byType[Piece::Queen]))
+			| (BishopAttacks(ksq, occupancy) & (byType[Piece::Bishop] | byType[Piece::Queen])))
+			& pieces(side) & occupancy) != 0;
+	}
+
+	if (IsCastle(move))
+	{
+		int rookFrom;
+		int rookTo;
+
+		CastlingRookSquares(move, rookFrom, rookTo);
+		occupancy = (occupancy ^ SquareBB(rookFrom)) | SquareBB(rookTo);
+
+		return (RookAttacks(rookTo, occupancy) & SquareBB(ksq)) != 0;
+	}
+
+	return false;
+}
+
+void Position::computeKey()
+{
+	zobristKey = 0;
+
+	for (Bitboard b = occupied(); b; )
+	{
+		int sq = PopLsb(b);
+		zobristKey ^= ZOBRIST.pieceSquare[colorOn(sq)][board[sq]][sq];
+	}
+
+	zobristKey ^= ZOBRIST.castling[castling];
+
+	if (ep != NO_SQUARE)
+	{
+		zobristKey ^= ZOBRIST.epFile[FileOf(ep)];
+	}
+
+	if (side == Color::Black)
+	{
+		zobristKey ^= ZOBRIST.side;
+	}
+}
+
+int Position::repetitions() const
+{
+	int count = 0;
+	int end = fiftyMoveCounter < historySize ? fiftyMoveCounter : historySize;
+
+	// Only positions with the same side to move can repeat, so step back two plies at a time
+	for (int i = 2; i <= end; i += 2)
+	{
+		if (history[historySize - i].key == zobristKey)
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+void Position::put(Piece piece, Color color, int sq)
+{
+	Bitboard b = SquareBB(sq);
+
+	board[sq] = piece;
+	byType[0] |= b;
+	byType[piece] |= b;
+	byColor[color] |= b;
+
+	psqScore.mg += PSQ.scores[color][piece][sq].mg;
+	psqScore.eg += PSQ.scores[color][piece][sq].eg;
+	phaseValue += PHASE_WEIGHT[piece];
+
+	// The material key holds one key per piece counted, the nth piece of a kind taking the square-n key
+	materialKeyValue ^= ZOBRIST.pieceSquare[color][piece][Popcount(pieces(color, piece)) - 1];
+
+	if (piece == Piece::Pawn)
+	{
+		pawnKeyValue ^= ZOBRIST.pieceSquare[color][Piece::Pawn][sq];
+	}
+}
+
+void Position::remove(int sq)
+{
+	Bitboard b = SquareBB(sq);
+	Color color = colorOn(sq);
+	const Score& score = PSQ.scores[color][board[sq]][sq];
+
+	psqScore.mg -= score.mg;
+	psqScore.eg -= score.eg;
+	phaseValue -= PHASE_WEIGHT[board[sq]];
+	materialKeyValue ^= ZOBRIST.pieceSquare[color][board[sq]][Popcount(pieces(color, board[sq])) - 1];
+
+	if (board[sq] == Piece::Pawn)
+	{
+		pawnKeyValue ^= ZOBRIST.pieceSquare[color][Piece::Pawn][sq];
+	}
+
+	byType[0] &= ~b;
+	byType[board[sq]] &= ~b;
+	byColor[Color::White] &= ~b;
+	byColor[Color::Black] &= ~b;
+	board[sq] = Piece::NoPiece;
+}
+
+void Position::movePiece(int from, int to)
+{
+	Bitboard fromTo = SquareBB(from) | SquareBB(to);
+	Color color = colorOn(from);
+	const Score& fromScore = PSQ.scores[color][board[from]][from];
+	const Score& toScore = PSQ.scores[color][board[from]][to];
+
+	psqScore.mg += toScore.mg - fromScore.mg;
+	psqScore.eg += toScore.eg - fromScore.eg;
+
+	if (board[from] == Piece::Pawn)
+	{
+		pawnKeyValue ^= ZOBRIST.pieceSquare[color][Piece::Pawn][from] ^ ZOBRIST.pieceSquare[color][Piece::Pawn][to];
+	}
+
+	byType[0] ^= fromTo;
+	byType[board[from]] ^= fromTo;
+	byColor[color] ^= fromTo;
+	board[to] = board[from];
+	board[from] = Piece::NoPiece;
+}
+
+void Position::make(Move move)
+{
+	int from = FromSquare(move);
+	int to = ToSquare(move);
+	int flags = MoveFlags(move);
+	Color us = side;
+	Color them = Opponent(us);
+	Piece moving = board[from];
+	uint64_t key = zobristKey ^ ZOBRIST.side;
+	UndoInfo& undo = pushUndo();
+
+	fiftyMoveCounter++;
+
+	if (ep != NO_SQUARE)
+	{
+		key ^= ZOBRIST.epFile[FileOf(ep)];
+		ep = NO_SQUARE;
+	}
+
+	if (flags == EnPassant)
+	{
+		int capturedSquare = us == Color::White ? to - 8 : to + 8;
+
+		undo.captured = Piece::Pawn;
+		key ^= ZOBRIST.pieceSquare[them][Piece::Pawn][capturedSquare];
+		remove(capturedSquare);
+	}
+	else if (IsCapture(move))
+	{
+		undo.captured = board[to];
+		key ^= ZOBRIST.pieceSquare[them][board[to]][to];
+		remove(to);
+	}
+
+	if (IsCastle(move))
+	{
+		int rookFrom, rookTo;
+		CastlingRookSquares(move, rookFrom, rookTo);
+
+		key ^= ZOBRIST.pieceSquare[us][Piece::Rook][rookFrom] ^ ZOBRIST.pieceSquare[us][Piece::Rook][rookTo];
+		movePiece(rookFrom, rookTo);
+	}
+
+	key ^= ZOBRIST.pieceSquare[us][moving][from] ^ ZOBRIST.pieceSquare[us][moving][to];
+	movePiece(from, to);
+
+	if (IsPromotion(move))
+	{
+		key ^= ZOBRIST.pieceSquare[us][Piece::Pawn][to] ^ ZOBRIST.pieceSquare[us][PromotionPiece(move)][to];
+		remove(to);
+		put(PromotionPiece(move), us, to);
+	}
+
+	if (moving == Piece::Pawn || undo.captured != Piece::NoPiece)
+	{
+		fiftyMoveCounter = 0;
+	}
+
+	// The en passant square is only recorded when an enemy pawn can actually take
+	if (flags == DoublePush)
+	{
+		int passed = (from + to) / 2;
+
+		if (PawnAttacks(us, passed) & pieces(them, Piece::Pawn))
+		{
+			ep = passed;
+			key ^= ZOBRIST.epFile[FileOf(ep)];
+		}
+	}
+
+	key ^= ZOBRIST.castling[castling];
+	castling &= CASTLING_MASK.squares[from] & CASTLING_MASK.squares[to];
+	key ^= ZOBRIST.castling[castling];
+
+	zobristKey = key;
+	checkersBB = attackersTo(kingSquare(them), occupied()) & pieces(us);
+	side = them;
+	ply++;
+}
+
+void Position::unmake(Move move)
+{
+	int from = FromSquare(move);
+	int to = ToSquare(move);
+	Color them = side;
+	Color us = Opponent(them);
+	const UndoInfo& undo = history[--historySize];
+
+	side = us;
+	ply--;
+
+	if (IsPromotion(move))
+	{
+		remove(to);
+		put(Piece::Pawn, us, to);
+	}
+
+	movePiece(to, from);
+
+	if (IsCastle(move))
+	{
+		int rookFrom, rookTo;
+		CastlingRookSquares(move, rookFrom, rookTo);
+		movePiece(rookTo, rookFrom);
+	}
+
+	if (MoveFlags(move) == EnPassant)
+	{
+		put(Piece::Pawn, them, us == Color::White ? to - 8 : to + 8);
+	}
+	else if (undo.captured != Piece::NoPiece)
+	{
+		put(undo.captured, them, to);
+	}
+
+	castling = undo.castlingRights;
+	ep = undo.epSquare;
+	fiftyMoveCounter = undo.rule50;
+	zobristKey = undo.key;
+	checkersBB = undo.checkers;
+}
+
+void Position::makeNull()
+{
+	uint64_t key = zobristKey ^ ZOBRIST.side;
+
+	pushUndo();
+
+	if (ep != NO_SQUARE)
+	{
+		key ^= ZOBRIST.epFile[FileOf(ep)];
+		ep = NO_SQUARE;
+	}
+
+	fiftyMoveCounter = 0;
+	zobristKey = key;
+	checkersBB = 0;
+	side = Opponent(side);
+	ply++;
+}
+
+void Position::unmakeNull()
+{
+	const UndoInfo& undo = history[--historySize];
+
+	side = Opponent(side);
+	ply--;
+	ep = undo.epSquare;
+	fiftyMoveCounter = undo.rule50;
+	zobristKey = undo.key;
+	checkersBB = undo.checkers;
+}
+
+UndoInfo& Position::pushUndo()
+{
+	// Doubling keeps the cost per ply constant however long the game runs
+	if (historySize == (int)history.size())
+	{
+		history.resize(history.size() * 2);
+	}
+
+	UndoInfo& undo = history[historySize++];
+	undo.key = zobristKey;
+	undo.checkers = checkersBB;
+	undo.captured = Piece::NoPiece;
+	undo.castlingRights = castling;
+	undo.epSquare = ep;
+	undo.rule50 = fiftyMoveCounter;
+
+	return undo;
+}
@@ -0,0 +1,152 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <string>
+#include <vector>
+
+#include "Bitboard.h"
+#include "Move.h"
+#include "Piece.cpp"
+#include "Color.cpp"
+
+constexpr int NUM_PIECE_TYPES = 7; // indexed by Piece, slot 0 holds every piece
+constexpr int NUM_COLORS = 3; // indexed by Color
+constexpr int NO_SQUARE = 64;
+// Undo records allocated up front; longer games grow the stack
+constexpr int RESERVED_GAME_PLIES = 1024;
+
+enum CastlingRight
+{
+	WhiteKingSide = 1,
+	WhiteQueenSide = 2,
+	BlackKingSide = 4,
+	BlackQueenSide = 8,
+	AllCastling = 15
+};
+
+// With every knight, bishop, rook and queen on the board; 0 with only pawns and kings left
+constexpr int MAX_PHASE = 24;
+
+inline Color Opponent(Color c) { return Color(Color::Black + Color::White - c); }
+
+// Middlegame and endgame halves of an evaluation term, in centipawns from White's point of view
+struct Score
+{
+	int mg;
+	int eg;
+};
+
+// What make() overwrites, so unmake() can restore it without recomputing anything.
+// The stored keys double as the game history used for repetition detection.
+struct UndoInfo
+{
+	uint64_t key;
+	Bitboard checkers;
+	Piece captured;
+	int castlingRights;
+	int epSquare;
+	int rule50;
+};
+
+class Position;
+
+// The squares each kind of piece of the side to move would give check from, and the pieces of that
+// side whose move can uncover a check. Filled once per node, so that givesCheck() costs a lookup.
+struct CheckInfo
+{
+	explicit CheckInfo(const Position& pos);
+
+	Bitboard checkSquares[NUM_PIECE_TYPES]; // indexed by Piece
+	Bitboard discoverers;
+	int kingSquare; // of the side not to move
+};
+
+class Position
+{
+public:
+	Position();
+	void clear();
+	void setStartPosition();
+	// Returns false and leaves the position cleared when the FEN is malformed
+	bool setFen(const std::string& fen);
+	void put(Piece piece, Color color, int sq);
+	void remove(int sq);
+	void movePiece(int from, int to);
+
+	// The move must be legal in this position; unmake must receive the same move, in reverse order
+	void make(Move move);
+	void unmake(Move move);
+	// Passes the turn, for null-move pruning. Not allowed in check. Repetitions are not looked for
+	// across a null move.
+	void makeNull();
+	void unmakeNull();
+
+	Bitboard occupied() const { return byType[0]; }
+	Bitboard pieces(Piece piece) const { return byType[piece]; }
+	Bitboard pieces(Color color) const { return byColor[color]; }
+	Bitboard pieces(Color color, Piece piece) const { return byColor[color] & byType[piece]; }
+	Piece pieceOn(int sq) const { return board[sq]; }
+	// Only meaningful for occupied squares
+	Color colorOn(int sq) const { return (byColor[Color::White] & SquareBB(sq)) ? Color::White : Color::Black; }
+	bool isEmpty(int sq) const { return board[sq] == Piece::NoPiece; }
+	int kingSquare(Color color) const { return Lsb(pieces(color, Piece::King)); }
+
+	// Pieces of both colors attacking sq, with the given occupancy blocking the sliders
+	Bitboard attackersTo(int sq, Bitboard occupancy) const;
+	bool isAttacked(int sq, Color by) const { return (attackersTo(sq, occupied()) & pieces(by)) != 0; }
+	// Enemy pieces giving check to the side to move, kept up to date by make() and unmake()
+	Bitboard checkers() const { return checkersBB; }
+	bool inCheck() const { return checkersBB != 0; }
+	// Pieces of either color that are the only blocker between a slider of color by and the king of color king
+	Bitboard pinned(Color king, Color by) const;
+	// Whether a legal move of the side to move checks the enemy king, without making it
+	bool givesCheck(Move move, const CheckInfo& info) const;
+
+	Color sideToMove() const { return side; }
+	int castlingRights() const { return castling; }
+	int epSquare() const { return ep; }
+	int rule50() const { return fiftyMoveCounter; }
+	int gamePly() const { return ply; }
+
+	// Material and piece-square scores, and the game phase of the material left. Both are kept up
+	// to date by put(), remove() and movePiece(), so reading them costs nothing.
+	Score psq() const { return psqScore; }
+	int phase() const { return phaseValue; }
+
+	// Zobrist key of pieces, side to move, castling rights and en passant file
+	uint64_t key() const { return zobristKey; }
+	// Keys of the pawns alone and of the number of pieces of each kind, for the evaluation caches
+	uint64_t pawnKey() const { return pawnKeyValue; }
+	uint64_t materialKey() const { return materialKeyValue; }
+	// Earlier occurrences of this position since the last capture or pawn move
+	int repetitions() const;
+	bool isThreefoldRepetition() const { return repetitions() >= 2; }
+	// Whether the 50-move rule allows a draw claim; a checkmate on the 100th ply still wins
+	bool isFiftyMoveDraw() const { return fiftyMoveCounter >= 100; }
+
+private:
+	Bitboard byType[NUM_PIECE_TYPES];
+	Bitboard byColor[NUM_COLORS];
+	Piece board[NUM_SQUARES];
+	Color side;
+	int castling;
+	int ep;
+	int fiftyMoveCounter;
+	int ply;
+	uint64_t zobristKey;
+	Bitboard checkersBB;
+	Score psqScore;
+	int phaseValue;
+	uint64_t pawnKeyValue;
+	uint64_t materialKeyValue;
+
+	void computeKey();
+	UndoInfo& pushUndo();
+
+	// One record per ply since the position was set up, so unmake() reaches back to the first
+	// move and repetitions are found over the whole game
+	std::vector<UndoInfo> history;
+	int historySize;
+};
+
+#endif
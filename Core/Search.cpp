@@ -0,0 +1,770 @@
+#include "Search.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "Evaluate.h"
+#include "MoveList.h"
+#include "MovePicker.h"
+#include "Nnue.h"
+#include "See.h"
+
+namespace
+{
+	// How often, in nodes, the clock and node budget are checked
+	constexpr uint64_t CHECK_INTERVAL = 1024;
+
+	// Margins in centipawns per ply of remaining depth, and the depths each pruning applies to
+	constexpr int REVERSE_FUTILITY_DEPTH = 6;
+	constexpr int REVERSE_FUTILITY_MARGIN = 80;
+	constexpr int FUTILITY_DEPTH = 3;
+	constexpr int FUTILITY_MARGIN = 150;
+	constexpr int LATE_MOVE_PRUNING_DEPTH = 4;
+	constexpr int NULL_MOVE_DEPTH = 3;
+	// Null move cutoffs from this depth on are confirmed by a search without null moves
+	constexpr int NULL_MOVE_VERIFY_DEPTH = 12;
+
+	// Iterations from this depth on start with a window of this half width around the last score
+	constexpr int ASPIRATION_DEPTH = 4;
+	constexpr int ASPIRATION_WINDOW = 25;
+
+	// Helper threads skip iterations so they spread over depths: helper i searches runs of
+	// SKIP_SIZE[i] depths and skips the next run, shifted by SKIP_PHASE[i]. The pattern repeats
+	// every SKIP_PATTERNS helpers and moves with the game ply, so it changes from move to move.
+	constexpr int SKIP_PATTERNS = 20;
+	constexpr int SKIP_SIZE[SKIP_PATTERNS] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+	constexpr int SKIP_PHASE[SKIP_PATTERNS] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+	// Late move reductions grow with the logarithm of both the depth and the move number
+	struct ReductionTable
+	{
+		int plies[MAX_PLY][MAX_MOVES];
+
+		ReductionTable()
+		{
+			for (int depth = 0; depth < MAX_PLY; depth++)
+			{
+				for (int move = 0; move < MAX_MOVES; move++)
+				{
+					plies[depth][move] = depth && move ? (int)(0.75 + std::log(depth) * std::log(move) / 2.25) : 0;
+				}
+			}
+		}
+	};
+
+	const ReductionTable REDUCTIONS;
+
+	// Mate scores are stored as distance from the stored node rather than from the root
+	int ScoreToTT(int score, int ply)
+	{
+		return score >= VALUE_MATE_IN_MAX_PLY ? score + ply : score <= -VALUE_MATE_IN_MAX_PLY ? score - ply : score;
+	}
+
+	int ScoreFromTT(int score, int ply)
+	{
+		return score >= VALUE_MATE_IN_MAX_PLY ? score - ply : score <= -VALUE_MATE_IN_MAX_PLY ? score + ply : score;
+	}
+
+	void HalveTable(int* table, size_t size)
+	{
+		for (size_t i = 0; i < size; i++)
+		{
+			table[i] /= 2;
+		}
+	}
+}
+
+Search::Search(TranspositionTable& table, int id) : tt(table), threadId(id), nodes(0), stopped(false), stopRequested(false)
+{
+	memset(history, 0, sizeof(history));
+	memset(counterHistory, 0, sizeof(counterHistory));
+}
+
+SearchResult Search::think(const Position& position, const SearchLimits& searchLimits)
+{
+	pos = position;
+	limits = searchLimits;
+	start = std::chrono::steady_clock::now();
+	nodes.store(0, std::memory_order_relaxed);
+	stopped = false;
+	previousPvLength = 0;
+	nmpMinPly = 0;
+	useNnue = network != nullptr;
+	pawnTable.resetStats();
+	materialTable.resetStats();
+	counters.reset();
+	memset(iterationNodes, 0, sizeof(iterationNodes));
+	memset(iterationTime, 0, sizeof(iterationTime));
+
+	if (useNnue)
+	{
+		accumulators.reset(pos, *network);
+	}
+
+	for (int ply = 0; ply < MAX_PLY; ply++)
+	{
+		killers[ply][0] = killers[ply][1] = NO_MOVE;
+	}
+
+	// History carries over between moves at half weight
+	HalveTable(&history[0][0][0], sizeof(history) / sizeof(int));
+	HalveTable(&counterHistory[0][0][0][0], sizeof(counterHistory) / sizeof(int));
+
+	SearchResult result = {};
+	int maxDepth = limits.depth > 0 && limits.depth < MAX_PLY ? limits.depth : MAX_PLY - 1;
+
+	MoveList rootMoves(pos);
+
+	if (rootMoves.empty())
+	{
+		result.score = pos.inCheck() ? -VALUE_MATE : 0;
+		return result;
+	}
+
+	// Even a budget too small for one iteration still returns a legal move
+	result.bestMove = rootMoves[0];
+
+	for (int depth = 1; depth <= maxDepth; depth++)
+	{
+		if (threadId > 0)
+		{
+			int pattern = (threadId - 1) % SKIP_PATTERNS;
+
+			if ((depth + pos.gamePly() + SKIP_PHASE[pattern]) / SKIP_SIZE[pattern] % 2)
+			{
+				continue;
+			}
+		}
+
+		int alpha = -VALUE_INFINITE;
+		int beta = VALUE_INFINITE;
+		int delta = ASPIRATION_WINDOW;
+		int score;
+		uint64_t iterationStartNodes = nodeCount();
+		int64_t iterationStartTime = elapsed();
+
+		if (options.aspirationWindows && depth >= ASPIRATION_DEPTH && result.depth > 0
+			&& result.score > -VALUE_MATE_IN_MAX_PLY && result.score < VALUE_MATE_IN_MAX_PLY)
+		{
+			alpha = result.score - delta > -VALUE_INFINITE ? result.score - delta : -VALUE_INFINITE;
+			beta = result.score + delta < VALUE_INFINITE ? result.score + delta : VALUE_INFINITE;
+		}
+
+		// A score outside the window is only a bound; search again with that side widened, half as
+		// much more each time
+		while (true)
+		{
+			score = negamax(depth, 0, alpha, beta);
+
+			if (stopped || (score > alpha && score < beta))
+			{
+				break;
+			}
+
+			if (score <= alpha)
+			{
+				alpha = score - delta > -VALUE_INFINITE ? score - delta : -VALUE_INFINITE;
+			}
+			else
+			{
+				beta = score + delta < VALUE_INFINITE ? score + delta : VALUE_INFINITE;
+			}
+
+			delta += delta / 2;
+		}
+
+		// An interrupted iteration is discarded, its moves were not all searched
+		if (stopped)
+		{
+			break;
+		}
+
+		iterationNodes[depth] = nodeCount() - iterationStartNodes;
+		iterationTime[depth] = elapsed() - iterationStartTime;
+
+		result.score = score;
+		result.depth = depth;
+		result.pvLength = pvLength[0];
+
+		for (int i = 0; i < pvLength[0]; i++)
+		{
+			result.pv[i] = previousPv[i] = pvTable[0][i];
+		}
+
+		previousPvLength = pvLength[0];
+		result.bestMove = result.pv[0];
+		result.nodes = nodeCount();
+		result.elapsed = elapsed();
+		fillStats(result);
+
+		if (onIteration)
+		{
+			onIteration(result);
+		}
+
+		// A forced mate found within this depth cannot get any shorter
+		if (score >= VALUE_MATE_IN_MAX_PLY || score <= -VALUE_MATE_IN_MAX_PLY)
+		{
+			break;
+		}
+	}
+
+	result.nodes = nodeCount();
+	result.elapsed = elapsed();
+	fillStats(result);
+
+	return result;
+}
+
+int Search::negamax(int depth, int ply, int alpha, int beta)
+{
+	pvLength[ply] = 0;
+
+	// Only this thread writes the counter, a plain load and store keeps it free of locked instructions
+	uint64_t count = nodes.load(std::memory_order_relaxed) + 1;
+	nodes.store(count, std::memory_order_relaxed);
+
+	if (count % CHECK_INTERVAL == 0 && shouldStop())
+	{
+		return 0;
+	}
+
+	if (ply > 0 && (pos.isFiftyMoveDraw() || pos.repetitions() > 0))
+	{
+		return 0;
+	}
+
+	if (depth <= 0)
+	{
+		return quiescence(ply, alpha, beta);
+	}
+
+	if (ply >= MAX_PLY - 1)
+	{
+		return evaluate();
+	}
+
+	int alphaOriginal = alpha;
+	Move ttMove = NO_MOVE;
+	TTData entry;
+
+	counters.increment(StatTtProbes);
+	bool ttHit = tt.probe(pos.key(), entry);
+
+	if (ttHit)
+	{
+		int ttScore = ScoreFromTT(entry.score, ply);
+		ttMove = entry.move;
+		counters.increment(StatTtHits);
+
+		// The root always searches, so the move to play comes with a full PV
+		if (ply > 0 && entry.depth >= depth
+			&& (entry.bound == BoundExact
+				|| (entry.bound == BoundLower && ttScore >= beta)
+				|| (entry.bound == BoundUpper && ttScore <= alpha)))
+		{
+			counters.increment(StatTtCutoffs);
+			return ttScore;
+		}
+	}
+
+	// Without a hash move, the line of the previous iteration is tried first
+	if (ttMove == NO_MOVE && ply < previousPvLength)
+	{
+		ttMove = previousPv[ply];
+	}
+
+	Move previous = ply > 0 ? currentMove[ply - 1] : NO_MOVE;
+	const int (*counter)[NUM_SQUARES] = previous != NO_MOVE
+		? counterHistory[pos.pieceOn(ToSquare(previous))][ToSquare(previous)] : nullptr;
+
+	bool pvNode = beta - alpha > 1;
+	bool inCheck = pos.inCheck();
+	bool mateBounds = alpha <= -VALUE_MATE_IN_MAX_PLY || beta >= VALUE_MATE_IN_MAX_PLY;
+	// The entry keeps the static evaluation of the position, which saves evaluating it again.
+	// -VALUE_INFINITE marks a node in check, where there is none.
+	int staticEval = inCheck ? -VALUE_INFINITE
+		: ttHit && entry.eval != -VALUE_INFINITE ? entry.eval : evaluate();
+
+	// Reverse futility: so far above beta near the horizon that no reply is expected to bring it back
+	if (options.reverseFutility && !pvNode && !inCheck && !mateBounds && depth <= REVERSE_FUTILITY_DEPTH
+		&& staticEval - REVERSE_FUTILITY_MARGIN * depth >= beta)
+	{
+		return staticEval;
+	}
+
+	// Null move: when passing still fails high, some real move will too. That is false in zugzwang,
+	// so it needs a piece besides the pawns, never follows another null move and is verified deep.
+	Color us = pos.sideToMove();
+
+	if (options.nullMove && !pvNode && !inCheck && !mateBounds && depth >= NULL_MOVE_DEPTH && ply >= nmpMinPly
+		&& staticEval >= beta && ply > 0 && currentMove[ply - 1] != NO_MOVE
+		&& (pos.pieces(us) & ~pos.pieces(Piece::Pawn) & ~pos.pieces(Piece::King)))
+	{
+		int reduction = 3 + depth / 4;
+
+		counters.increment(StatNullMoveTries);
+		currentMove[ply] = NO_MOVE;
+		makeNullMove();
+		int score = -negamax(depth - 1 - reduction, ply + 1, -beta, -beta + 1);
+		unmakeNullMove();
+
+		if (stopped)
+		{
+			return 0;
+		}
+
+		if (score >= beta)
+		{
+			// A mate found after passing is not proven
+			score = score >= VALUE_MATE_IN_MAX_PLY ? beta : score;
+
+			if (depth < NULL_MOVE_VERIFY_DEPTH || nmpMinPly > 0)
+			{
+				counters.increment(StatNullMoveCutoffs);
+				return score;
+			}
+
+			nmpMinPly = ply + 3 * (depth - reduction) / 4;
+			int verified = negamax(depth - reduction, ply, beta - 1, beta);
+			nmpMinPly = 0;
+
+			if (stopped)
+			{
+				return 0;
+			}
+
+			if (verified >= beta)
+			{
+				counters.increment(StatNullMoveCutoffs);
+				return score;
+			}
+		}
+	}
+
+	// Futility: quiet moves that do not give check cannot lift a static score this far below alpha
+	bool futile = options.futility && !pvNode && !inCheck && !mateBounds && depth <= FUTILITY_DEPTH
+		&& staticEval + FUTILITY_MARGIN * depth <= alpha;
+
+	MovePicker picker(pos, ttMove, killers[ply], history[us], counter);
+	CheckInfo checkInfo(pos);
+	int bestScore = -VALUE_INFINITE;
+	Move bestMove = NO_MOVE;
+	int moveCount = 0;
+	Move move;
+
+	while ((move = picker.next()) != NO_MOVE)
+	{
+		bool quiet = !IsCapture(move) && !IsPromotion(move);
+		bool givesCheck = pos.givesCheck(move, checkInfo);
+
+		moveCount++;
+
+		// Pruning only starts once a move has been searched, so a mate is never missed
+		bool canPrune = !pvNode && !inCheck && quiet && bestScore > -VALUE_MATE_IN_MAX_PLY;
+
+		// Late move pruning: well ordered quiet moves this far down the list almost never cut off
+		if (options.lateMovePruning && canPrune && depth <= LATE_MOVE_PRUNING_DEPTH && moveCount > 3 + depth * depth)
+		{
+			picker.skipQuietMoves();
+			continue;
+		}
+
+		// Decided before the move is made, so a pruned move costs no make and unmake
+		if (futile && canPrune && !givesCheck)
+		{
+			continue;
+		}
+
+		currentMove[ply] = move;
+		makeMove(move);
+
+		tt.prefetch(pos.key());
+
+		// Late move reductions: later quiet moves get a shallower null window search first and are
+		// searched again in full only if they beat alpha
+		int reduction = 0;
+
+		if (options.lateMoveReductions && quiet && !inCheck && !givesCheck && depth >= 3 && moveCount > 1)
+		{
+			reduction = REDUCTIONS.plies[depth][moveCount < MAX_MOVES ? moveCount : MAX_MOVES - 1] - (pvNode ? 1 : 0);
+			reduction = reduction < 0 ? 0 : reduction > depth - 2 ? depth - 2 : reduction;
+		}
+
+		// Starting above alpha forces a search at full depth below
+		int score = alpha + 1;
+
+		if (reduction > 0)
+		{
+			score = -negamax(depth - 1 - reduction, ply + 1, -alpha - 1, -alpha);
+		}
+
+		// Principal variation search: after the first move a null window only has to show the move is
+		// no better than alpha; the full window is opened for the rare move that lands inside it
+		if (options.principalVariation && moveCount > 1 && score > alpha)
+		{
+			score = -negamax(depth - 1, ply + 1, -alpha - 1, -alpha);
+		}
+
+		if (score > alpha && (!options.principalVariation || moveCount == 1 || score < beta))
+		{
+			score = -negamax(depth - 1, ply + 1, -beta, -alpha);
+		}
+
+		unmakeMove(move);
+
+		if (stopped)
+		{
+			return 0;
+		}
+
+		if (score > bestScore)
+		{
+			bestScore = score;
+			bestMove = move;
+
+			if (score > alpha)
+			{
+				alpha = score;
+
+				pvTable[ply][0] = move;
+
+				for (int i = 0; i < pvLength[ply + 1]; i++)
+				{
+					pvTable[ply][i + 1] = pvTable[ply + 1][i];
+				}
+
+				pvLength[ply] = pvLength[ply + 1] + 1;
+
+				if (alpha >= beta)
+				{
+					counters.increment(StatBetaCutoffs);
+
+					if (moveCount == 1)
+					{
+						counters.increment(StatFirstMoveCutoffs);
+					}
+
+					if (!IsCapture(move) && !IsPromotion(move))
+					{
+						updateQuietStats(move, ply, depth);
+					}
+
+					break;
+				}
+			}
+		}
+	}
+
+	if (moveCount == 0)
+	{
+		return pos.inCheck() ? -VALUE_MATE + ply : 0;
+	}
+
+	Bound bound = bestScore >= beta ? BoundLower : bestScore > alphaOriginal ? BoundExact : BoundUpper;
+	tt.store(pos.key(), bound == BoundUpper ? NO_MOVE : bestMove, ScoreToTT(bestScore, ply), staticEval, depth, bound);
+
+	return bestScore;
+}
+
+int Search::quiescence(int ply, int alpha, int beta)
+{
+	pvLength[ply] = 0;
+	counters.increment(StatQNodes);
+
+	uint64_t count = nodes.load(std::memory_order_relaxed) + 1;
+	nodes.store(count, std::memory_order_relaxed);
+
+	if (count % CHECK_INTERVAL == 0 && shouldStop())
+	{
+		return 0;
+	}
+
+	if (ply >= MAX_PLY - 1)
+	{
+		return evaluate();
+	}
+
+	// Stand pat: the side to move is not forced to capture. In check every evasion is searched instead.
+	bool inCheck = pos.inCheck();
+	int bestScore = -VALUE_INFINITE;
+
+	if (!inCheck)
+	{
+		bestScore = evaluate();
+
+		if (bestScore >= beta)
+		{
+			return bestScore;
+		}
+
+		alpha = bestScore > alpha ? bestScore : alpha;
+	}
+
+	// Out of check only the captures are generated; a stalemate there is scored as it stands
+	Move moves[MAX_MOVES];
+	Move* end = GenerateLegal(pos, moves, inCheck ? AllMoves : Captures);
+
+	if (inCheck && end == moves)
+	{
+		return -VALUE_MATE + ply;
+	}
+
+	// Keep captures that do not lose material and queen promotions, best exchange first
+	Move captures[MAX_MOVES];
+	int scores[MAX_MOVES];
+	int size = 0;
+
+	for (Move* m = moves; m != end; m++)
+	{
+		Move move = *m;
+		int score = 0;
+
+		if (!inCheck)
+		{
+			if (IsPromotion(move) && PromotionPiece(move) != Piece::Queen)
+			{
+				continue;
+			}
+
+			score = See(pos, move);
+
+			if (score < 0)
+			{
+				continue;
+			}
+		}
+		else if (IsCapture(move))
+		{
+			score = See(pos, move);
+		}
+
+		int j = size++;
+
+		for (; j > 0 && scores[j - 1] < score; j--)
+		{
+			captures[j] = captures[j - 1];
+			scores[j] = scores[j - 1];
+		}
+
+		captures[j] = move;
+		scores[j] = score;
+	}
+
+	for (int i = 0; i < size; i++)
+	{
+		makeMove(captures[i]);
+		int score = -quiescence(ply + 1, -beta, -alpha);
+		unmakeMove(captures[i]);
+
+		if (stopped)
+		{
+			return 0;
+		}
+
+		if (score > bestScore)
+		{
+			bestScore = score;
+
+			if (score > alpha)
+			{
+				alpha = score;
+
+				if (alpha >= beta)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	return bestScore;
+}
+
+void Search::addCounters(SearchStats& stats) const
+{
+	for (int i = 0; i < NUM_SEARCH_COUNTERS; i++)
+	{
+		stats.counters[i] += counters.get(SearchCounter(i));
+	}
+}
+
+void Search::countCacheProbes()
+{
+	counters.set(StatPawnProbes, pawnTable.probes());
+	counters.set(StatPawnHits, pawnTable.hits());
+	counters.set(StatMaterialProbes, materialTable.probes());
+	counters.set(StatMaterialHits, materialTable.hits());
+}
+
+void Search::fillStats(SearchResult& result)
+{
+	countCacheProbes();
+
+	result.stats = SearchStats();
+	addCounters(result.stats);
+	result.stats.iterations = result.depth;
+
+	for (int depth = 1; depth <= result.depth; depth++)
+	{
+		result.stats.iterationNodes[depth] = iterationNodes[depth];
+		result.stats.iterationTime[depth] = iterationTime[depth];
+	}
+}
+
+int Search::evaluate()
+{
+	return useNnue ? NnueEvaluate(pos, accumulators) : Evaluate(pos, pawnTable, materialTable);
+}
+
+void Search::makeMove(Move move)
+{
+	if (useNnue)
+	{
+		accumulators.push(pos, move);
+	}
+
+	pos.make(move);
+}
+
+void Search::unmakeMove(Move move)
+{
+	pos.unmake(move);
+
+	if (useNnue)
+	{
+		accumulators.pop();
+	}
+}
+
+void Search::makeNullMove()
+{
+	if (useNnue)
+	{
+		accumulators.pushNull();
+	}
+
+	pos.makeNull();
+}
+
+void Search::unmakeNullMove()
+{
+	pos.unmakeNull();
+
+	if (useNnue)
+	{
+		accumulators.pop();
+	}
+}
+
+void Search::updateQuietStats(Move move, int ply, int depth)
+{
+	if (killers[ply][0] != move)
+	{
+		killers[ply][1] = killers[ply][0];
+		killers[ply][0] = move;
+	}
+
+	int bonus = depth * depth;
+	int& score = history[pos.sideToMove()][FromSquare(move)][ToSquare(move)];
+	score += bonus;
+
+	// Halve the whole table long before the scores could overflow
+	if (score >= 1 << 17)
+	{
+		HalveTable(&history[pos.sideToMove()][0][0], NUM_SQUARES * NUM_SQUARES);
+	}
+
+	Move previous = ply > 0 ? currentMove[ply - 1] : NO_MOVE;
+
+	if (previous != NO_MOVE)
+	{
+		int (*counter)[NUM_SQUARES] = counterHistory[pos.pieceOn(ToSquare(previous))][ToSquare(previous)];
+		int& counterScore = counter[pos.pieceOn(FromSquare(move))][ToSquare(move)];
+		counterScore += bonus;
+
+		if (counterScore >= 1 << 17)
+		{
+			HalveTable(&counter[0][0], NUM_PIECE_TYPES * NUM_SQUARES);
+		}
+	}
+}
+
+bool Search::shouldStop()
+{
+	countCacheProbes();
+
+	// The main search always completes its first iteration so there is a move to play; a helper's
+	// result is never played, so it stops at once
+	if (threadId == 0 && previousPvLength == 0)
+	{
+		return false;
+	}
+
+	stopped = stopRequested.load(std::memory_order_relaxed)
+		|| (limits.nodes && (groupNodes ? groupNodes() : nodeCount()) >= limits.nodes)
+		|| (limits.moveTime && elapsed() >= limits.moveTime);
+
+	return stopped;
+}
+
+int64_t Search::elapsed() const
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string StatsSummary(const SearchResult& result)
+{
+	const SearchStats& stats = result.stats;
+	char text[256];
+
+	snprintf(text, sizeof(text), "qnodes %.0f%% tthits %.0f%% ttcuts %.0f%% firstcut %.0f%% ebf %.2f nullcut %.0f%% pawnhits %.0f%% materialhits %.0f%%",
+		result.nodes ? 100.0 * stats[StatQNodes] / result.nodes : 0, stats.percent(StatTtHits, StatTtProbes),
+		stats.percent(StatTtCutoffs, StatTtProbes), stats.percent(StatFirstMoveCutoffs, StatBetaCutoffs), stats.branchingFactor(),
+		stats.percent(StatNullMoveCutoffs, StatNullMoveTries), stats.percent(StatPawnHits, StatPawnProbes),
+		stats.percent(StatMaterialHits, StatMaterialProbes));
+
+	return text;
+}
+
+std::string StatsReport(const SearchResult& result)
+{
+	const SearchStats& stats = result.stats;
+	std::string report;
+	char line[256];
+
+	snprintf(line, sizeof(line), "nodes %llu time %lldms nps %.0f\n", (unsigned long long)result.nodes,
+		(long long)result.elapsed, result.elapsed > 0 ? result.nodes * 1000.0 / result.elapsed : 0);
+	report += line;
+	snprintf(line, sizeof(line), "qnodes %llu (%.1f%% of nodes)\n", (unsigned long long)stats[StatQNodes],
+		result.nodes ? 100.0 * stats[StatQNodes] / result.nodes : 0);
+	report += line;
+	snprintf(line, sizeof(line), "tt probes %llu hits %llu (%.1f%%) cutoffs %llu (%.1f%%)\n",
+		(unsigned long long)stats[StatTtProbes], (unsigned long long)stats[StatTtHits], stats.percent(StatTtHits, StatTtProbes),
+		(unsigned long long)stats[StatTtCutoffs], stats.percent(StatTtCutoffs, StatTtProbes));
+	report += line;
+	snprintf(line, sizeof(line), "beta cutoffs %llu on the first move %llu (%.1f%%)\n", (unsigned long long)stats[StatBetaCutoffs],
+		(unsigned long long)stats[StatFirstMoveCutoffs], stats.percent(StatFirstMoveCutoffs, StatBetaCutoffs));
+	report += line;
+	snprintf(line, sizeof(line), "null moves %llu cutoffs %llu (%.1f%%)\n", (unsigned long long)stats[StatNullMoveTries],
+		(unsigned long long)stats[StatNullMoveCutoffs], stats.percent(StatNullMoveCutoffs, StatNullMoveTries));
+	report += line;
+	snprintf(line, sizeof(line), "pawn table probes %llu hits %llu (%.1f%%)\n", (unsigned long long)stats[StatPawnProbes],
+		(unsigned long long)stats[StatPawnHits], stats.percent(StatPawnHits, StatPawnProbes));
+	report += line;
+	snprintf(line, sizeof(line), "material table probes %llu hits %llu (%.1f%%)\n", (unsigned long long)stats[StatMaterialProbes],
+		(unsigned long long)stats[StatMaterialHits], stats.percent(StatMaterialHits, StatMaterialProbes));
+	report += line;
+	snprintf(line, sizeof(line), "effective branching factor %.2f\n", stats.branchingFactor());
+	report += line;
+
+	for (int depth = 1; depth <= stats.iterations; depth++)
+	{
+		snprintf(line, sizeof(line), "iteration %d nodes %llu time %lldms\n", depth,
+			(unsigned long long)stats.iterationNodes[depth], (long long)stats.iterationTime[depth]);
+		report += line;
+	}
+
+	return report;
+}
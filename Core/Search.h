@@ -0,0 +1,235 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "Material.h"
+#include "Memory.h"
+#include "Move.h"
+#include "Nnue.h"
+#include "Pawns.h"
+#include "Position.h"
+#include "TranspositionTable.h"
+
+constexpr int MAX_PLY = 128;
+constexpr int VALUE_INFINITE = 32001;
+constexpr int VALUE_MATE = 32000;
+// Scores beyond this are mates, VALUE_MATE minus the distance in plies
+constexpr int VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+// Zero means no limit. Without any limit the search runs to MAX_PLY.
+struct SearchLimits
+{
+	int depth;
+	int64_t moveTime; // milliseconds
+	uint64_t nodes;
+};
+
+// Search enhancements, all on by default. Each one can be switched off to measure what it is worth.
+struct SearchOptions
+{
+	bool principalVariation = true;
+	bool aspirationWindows = true;
+	bool nullMove = true;
+	bool lateMoveReductions = true;
+	bool reverseFutility = true;
+	bool futility = true;
+	bool lateMovePruning = true;
+};
+
+// Events counted by every search thread
+enum SearchCounter
+{
+	StatQNodes,
+	StatTtProbes,
+	StatTtHits,
+	StatTtCutoffs,
+	StatBetaCutoffs,
+	StatFirstMoveCutoffs,
+	StatNullMoveTries,
+	StatNullMoveCutoffs,
+	StatPawnProbes,
+	StatPawnHits,
+	StatMaterialProbes,
+	StatMaterialHits,
+	NUM_SEARCH_COUNTERS
+};
+
+// Counters of one search thread, on cache lines of their own. Only the owning thread writes them,
+// with a relaxed load and store instead of a locked increment, so counting costs a plain add;
+// any thread may read them while the search runs.
+class alignas(64) SearchCounters
+{
+public:
+	SearchCounters() { reset(); }
+
+	void increment(SearchCounter counter) { add(counter, 1); }
+	void add(SearchCounter counter, uint64_t amount)
+	{
+		values[counter].store(values[counter].load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+	void set(SearchCounter counter, uint64_t value) { values[counter].store(value, std::memory_order_relaxed); }
+	uint64_t get(SearchCounter counter) const { return values[counter].load(std::memory_order_relaxed); }
+
+	void reset()
+	{
+		for (std::atomic<uint64_t>& value : values)
+		{
+			value.store(0, std::memory_order_relaxed);
+		}
+	}
+
+private:
+	std::atomic<uint64_t> values[NUM_SEARCH_COUNTERS];
+};
+
+// Counters summed over the threads of a search, and the cost of each iteration of the main thread
+struct SearchStats
+{
+	uint64_t counters[NUM_SEARCH_COUNTERS];
+	// Nodes and milliseconds spent on each depth up to the deepest completed one
+	int iterations;
+	uint64_t iterationNodes[MAX_PLY];
+	int64_t iterationTime[MAX_PLY];
+
+	uint64_t operator[](SearchCounter counter) const { return counters[counter]; }
+	// part / whole in percent, 0 when nothing was counted
+	double percent(SearchCounter part, SearchCounter whole) const
+	{
+		return counters[whole] ? 100.0 * counters[part] / counters[whole] : 0;
+	}
+	// Growth of the iteration cost per ply over the last two iterations, which evens out the
+	// difference between odd and even depths; 0 before the third iteration
+	double branchingFactor() const
+	{
+		return iterations >= 3 && iterationNodes[iterations - 2]
+			? std::sqrt((double)iterationNodes[iterations] / iterationNodes[iterations - 2]) : 0;
+	}
+};
+
+// Outcome of the deepest completed iteration
+struct SearchResult
+{
+	Move bestMove;
+	int score;
+	int depth;
+	uint64_t nodes;
+	int64_t elapsed; // milliseconds
+	int hashfull; // permille of the transposition table used by this search
+	int pvLength;
+	Move pv[MAX_PLY];
+	SearchStats stats;
+};
+
+// Hit and cutoff rates of the statistics on one line, for progress output
+std::string StatsSummary(const SearchResult& result);
+// Every counter and rate, then the nodes and time of each iteration, one item per line
+std::string StatsReport(const SearchResult& result);
+
+// Negamax alpha-beta with iterative deepening. The position is copied, so the caller's one is
+// never touched and may be played on while the result is used. The transposition table belongs
+// to whoever owns the search and may be shared with other searches.
+//
+// Each search thread owns one instance. Instances are allocated on page boundaries, so the node
+// counter, killers and history of one thread never share a cache line with another thread's, and
+// the whole object can be bound to the NUMA node its thread runs on.
+class alignas(64) Search
+{
+public:
+	// Thread 0 is the main search; helpers skip iterations by a pattern of their id so threads spread over depths
+	explicit Search(TranspositionTable& table, int id = 0);
+
+	static void* operator new(size_t size) { return AlignedAlloc(MEMORY_PAGE_SIZE, size); }
+	static void operator delete(void* memory) { AlignedFree(memory); }
+
+	SearchResult think(const Position& position, const SearchLimits& searchLimits);
+	// Not while think() runs
+	void setOptions(const SearchOptions& searchOptions) { options = searchOptions; }
+	// Null for the hand-written evaluation. Not while think() runs.
+	void setNetwork(std::shared_ptr<const Nnue> nnue) { network = nnue; }
+
+	// Nodes of the current or last search; may be read from another thread while searching
+	uint64_t nodeCount() const { return nodes.load(std::memory_order_relaxed); }
+	// Adds this thread's counters to stats; may be called from another thread while searching
+	void addCounters(SearchStats& stats) const;
+
+	// Safe to call from any thread. The flag stays set until resetStop(), so a stop that arrives
+	// before think() starts is not lost.
+	void stop() { stopRequested.store(true, std::memory_order_relaxed); }
+	void resetStop() { stopRequested.store(false, std::memory_order_relaxed); }
+
+	// Called on the searching thread after every completed iteration
+	std::function<void(const SearchResult&)> onIteration;
+	// Nodes of all the threads searching together with this one; when set, the node limit is
+	// checked against it instead of this thread's count
+	std::function<uint64_t()> groupNodes;
+
+private:
+	int negamax(int depth, int ply, int alpha, int beta);
+	// Captures only below the horizon, so the static evaluation is never taken in the middle of an exchange
+	int quiescence(int ply, int alpha, int beta);
+	// The network when one is loaded, the hand-written evaluation otherwise
+	int evaluate();
+	// Keep the network accumulators in step with the position
+	void makeMove(Move move);
+	void unmakeMove(Move move);
+	void makeNullMove();
+	void unmakeNullMove();
+	void updateQuietStats(Move move, int ply, int depth);
+	// Copies the evaluation cache lookups into the counters, where other threads can read them
+	void countCacheProbes();
+	void fillStats(SearchResult& result);
+	// Called every CHECK_INTERVAL nodes; also brings the cache counters up to date
+	bool shouldStop();
+	int64_t elapsed() const;
+
+	TranspositionTable& tt;
+	int threadId;
+	Position pos;
+	SearchLimits limits;
+	SearchOptions options;
+	std::chrono::steady_clock::time_point start;
+	std::atomic<uint64_t> nodes;
+	bool stopped;
+	std::atomic<bool> stopRequested;
+	SearchCounters counters;
+	// Nodes and time spent on each completed iteration
+	uint64_t iterationNodes[MAX_PLY];
+	int64_t iterationTime[MAX_PLY];
+
+	// Quiet moves that caused a cutoff at each ply, and a from-to score of cutoffs by side
+	Move killers[MAX_PLY][2];
+	int history[NUM_COLORS][NUM_SQUARES][NUM_SQUARES];
+	// Cutoffs of quiet moves by piece and destination, following the piece and destination of the move before
+	int counterHistory[NUM_PIECE_TYPES][NUM_SQUARES][NUM_PIECE_TYPES][NUM_SQUARES];
+	// Move being searched at each ply, NO_MOVE for a null move
+	Move currentMove[MAX_PLY];
+	// Null moves are not tried below this ply while a null move cutoff is being verified
+	int nmpMinPly;
+
+	// Pawn structure and material imbalance caches of this thread; they stay valid from one search to the next
+	PawnTable pawnTable;
+	MaterialTable materialTable;
+
+	// The network evaluates when there is one, the hand-written evaluation otherwise
+	std::shared_ptr<const Nnue> network;
+	// Whether this search evaluates with the network, fixed when it starts
+	bool useNnue;
+	AccumulatorStack accumulators;
+
+	// Triangular PV table: pvTable[ply] holds the line found below that ply
+	Move pvTable[MAX_PLY][MAX_PLY];
+	int pvLength[MAX_PLY];
+
+	// Line of the last completed iteration, tried first by the next one
+	Move previousPv[MAX_PLY];
+	int previousPvLength;
+};
+
+#endif
@@ -0,0 +1,229 @@
+#include "SearchThread.h"
+
+#include "Numa.h"
+
+SearchThread::SearchThread(size_t hashMegabytes) : tt(hashMegabytes), numaBinding(false), progress(MAX_PLY), busy(false)
+{
+	setThreads(1);
+}
+
+SearchThread::~SearchThread()
+{
+	stop();
+	join();
+}
+
+bool SearchThread::setHashSize(size_t megabytes, bool hugePages)
+{
+	stop();
+	join();
+
+	return tt.resize(megabytes, (int)std::thread::hardware_concurrency(), hugePages, numaBinding && NumaNodeCount() > 1);
+}
+
+void SearchThread::clearHash()
+{
+	stop();
+	join();
+
+	tt.clear((int)std::thread::hardware_concurrency());
+}
+
+void SearchThread::setThreads(int count)
+{
+	stop();
+	join();
+
+	searches.clear();
+
+	for (int id = 0; id < (count > 1 ? count : 1); id++)
+	{
+		searches.emplace_back(new Search(tt, id));
+		searches.back()->setOptions(options);
+		searches.back()->setNetwork(network);
+	}
+
+	setNumaBinding(numaBinding);
+
+	searches[0]->onIteration = [this](const SearchResult& result)
+	{
+		SearchInfo info = { result, false };
+		info.result.nodes = totalNodes();
+		info.result.hashfull = tt.hashfull();
+		addHelperCounters(info.result.stats);
+		progress.push(info);
+	};
+
+	// The node limit counts the helpers too
+	searches[0]->groupNodes = [this]() { return totalNodes(); };
+}
+
+void SearchThread::setNumaBinding(bool enabled)
+{
+	stop();
+	join();
+
+	numaBinding = enabled;
+
+	for (size_t i = 0; enabled && i < searches.size(); i++)
+	{
+		BindMemoryToNode(searches[i].get(), sizeof(Search), NumaNodeForThread((int)i));
+	}
+}
+
+void SearchThread::setOptions(const SearchOptions& searchOptions)
+{
+	stop();
+	join();
+
+	options = searchOptions;
+
+	for (std::unique_ptr<Search>& search : searches)
+	{
+		search->setOptions(options);
+	}
+}
+
+void SearchThread::setNetwork(std::shared_ptr<const Nnue> nnue)
+{
+	stop();
+	join();
+
+	network = nnue;
+
+	for (std::unique_ptr<Search>& search : searches)
+	{
+		search->setNetwork(network);
+	}
+}
+
+void SearchThread::start(const Position& pos, const SearchLimits& limits)
+{
+	stop();
+	join();
+
+	// Drop whatever the previous search left unread
+	SearchInfo stale;
+
+	while (progress.pop(stale))
+	{
+	}
+
+	for (auto& search : searches)
+	{
+		search->resetStop();
+	}
+
+	tt.newSearch();
+	busy = true;
+	started = std::chrono::steady_clock::now();
+
+	worker = std::thread([this, pos, limits]()
+	{
+		// Helpers run until the main search is done; only the main search watches the limits
+		std::vector<std::thread> helpers;
+		SearchLimits unlimited = {};
+
+		for (size_t i = 1; i < searches.size(); i++)
+		{
+			helpers.emplace_back([this, i, &pos, unlimited]()
+			{
+				if (numaBinding)
+				{
+					BindThreadToNode(NumaNodeForThread((int)i));
+				}
+
+				searches[i]->think(pos, unlimited);
+			});
+		}
+
+		if (numaBinding)
+		{
+			BindThreadToNode(NumaNodeForThread(0));
+		}
+
+		SearchInfo info = { searches[0]->think(pos, limits), true };
+
+		for (size_t i = 1; i < searches.size(); i++)
+		{
+			searches[i]->stop();
+		}
+
+		for (std::thread& helper : helpers)
+		{
+			helper.join();
+		}
+
+		info.result.nodes = totalNodes();
+		info.result.hashfull = tt.hashfull();
+		addHelperCounters(info.result.stats);
+		progress.push(info);
+	});
+}
+
+void SearchThread::stop()
+{
+	for (auto& search : searches)
+	{
+		search->stop();
+	}
+}
+
+bool SearchThread::poll(SearchInfo& info)
+{
+	if (!progress.pop(info))
+	{
+		return false;
+	}
+
+	if (info.finished)
+	{
+		busy = false;
+	}
+
+	return true;
+}
+
+void SearchThread::readCounters(SearchResult& result) const
+{
+	for (uint64_t& counter : result.stats.counters)
+	{
+		counter = 0;
+	}
+
+	for (const auto& search : searches)
+	{
+		search->addCounters(result.stats);
+	}
+
+	result.nodes = totalNodes();
+	result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+}
+
+uint64_t SearchThread::totalNodes() const
+{
+	uint64_t total = 0;
+
+	for (const auto& search : searches)
+	{
+		total += search->nodeCount();
+	}
+
+	return total;
+}
+
+void SearchThread::addHelperCounters(SearchStats& stats) const
+{
+	for (size_t i = 1; i < searches.size(); i++)
+	{
+		searches[i]->addCounters(stats);
+	}
+}
+
+void SearchThread::join()
+{
+	if (worker.joinable())
+	{
+		worker.join();
+	}
+}
@@ -0,0 +1,116 @@
+#ifndef SEARCHTHREAD_H
+#define SEARCHTHREAD_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Search.h"
+
+// Single producer, single consumer ring: one thread pushes, another pops in the same order, neither
+// ever waits. Nothing is dropped, so the producer must never get more than the capacity ahead.
+template<typename T>
+class ProgressQueue
+{
+public:
+	explicit ProgressQueue(size_t capacity) : buffers(capacity), head(0), tail(0) {}
+
+	// Producer thread only
+	void push(const T& value)
+	{
+		size_t last = tail.load(std::memory_order_relaxed);
+
+		buffers[last % buffers.size()] = value;
+		tail.store(last + 1, std::memory_order_release);
+	}
+
+	// Consumer thread only. Returns false when everything pushed has been popped.
+	bool pop(T& value)
+	{
+		size_t first = head.load(std::memory_order_relaxed);
+
+		if (first == tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		value = buffers[first % buffers.size()];
+		head.store(first + 1, std::memory_order_release);
+
+		return true;
+	}
+
+private:
+	std::vector<T> buffers;
+	std::atomic<size_t> head;
+	std::atomic<size_t> tail;
+};
+
+struct SearchInfo
+{
+	SearchResult result;
+	// Set on the final result of a search; the others are per-iteration progress
+	bool finished;
+};
+
+// Runs the search on worker threads so the caller, typically the render loop, never blocks.
+// With more than one thread it is a Lazy SMP search: helpers search the same root without any
+// coordination other than the shared transposition table, and the main search's result is played.
+// Every method is meant to be called from one thread.
+class SearchThread
+{
+public:
+	// The table is allocated at this size right away, so small instances never hold the default
+	explicit SearchThread(size_t hashMegabytes = TranspositionTable::DEFAULT_SIZE_MB);
+	~SearchThread();
+
+	// Waits for a running search to stop first. Returns false if the memory could not be allocated.
+	// hugePages asks for transparent huge pages behind the transposition table (Linux).
+	bool setHashSize(size_t megabytes, bool hugePages = false);
+	void clearHash();
+	// Main search plus helpers, at least one
+	void setThreads(int count);
+	int threadCount() const { return (int)searches.size(); }
+	// Pins every search thread to the cores of a NUMA node and keeps its tables on that node.
+	// The transposition table is interleaved over all nodes from the next setHashSize() on (Linux).
+	void setNumaBinding(bool enabled);
+	// Applies to the main search and every helper
+	void setOptions(const SearchOptions& searchOptions);
+	// Shared by the main search and every helper; null for the hand-written evaluation
+	void setNetwork(std::shared_ptr<const Nnue> nnue);
+
+	// Starts searching a copy of the position and returns immediately
+	void start(const Position& pos, const SearchLimits& limits);
+	void stop();
+
+	// True from start() until the finished result has been read by poll()
+	bool isBusy() const { return busy; }
+	// Counters, nodes and time of the current or last search as they stand, summed over every thread
+	// on demand; the rest of result is left alone. Safe while the search runs.
+	void readCounters(SearchResult& result) const;
+	// The next completed iteration or the final result, oldest first. Every iteration is
+	// delivered, however long the caller takes between calls.
+	bool poll(SearchInfo& info);
+
+private:
+	void join();
+	uint64_t totalNodes() const;
+	// The main search's counters come with its result; the helpers' are summed on demand
+	void addHelperCounters(SearchStats& stats) const;
+
+	// Declared before the searches, which keep a reference to it
+	TranspositionTable tt;
+	std::vector<std::unique_ptr<Search>> searches;
+	bool numaBinding;
+	SearchOptions options;
+	std::shared_ptr<const Nnue> network;
+	std::thread worker;
+	std::chrono::steady_clock::time_point started;
+	// Room for one entry per iteration and the final result, so a search can never overrun it
+	ProgressQueue<SearchInfo> progress;
+	bool busy;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "See.h"
+
+#include "Evaluate.h"
+
+namespace
+{
+	// Cheapest first; the king only captures last, when nothing defends the square any more
+	const Piece CAPTURE_ORDER[] = { Piece::Pawn, Piece::Knight, Piece::Bishop, Piece::Rook, Piece::Queen, Piece::King };
+}
+
+int See(const Position& pos, Move move)
+{
+	if (IsCastle(move))
+	{
+		return 0;
+	}
+
+	int from = FromSquare(move);
+	int to = ToSquare(move);
+	Piece attacker = pos.pieceOn(from);
+	Bitboard occupied = pos.occupied() ^ SquareBB(from);
+
+	// gain[d] is the balance after the d-th capture, assuming the other side stops there
+	int gain[32];
+	int d = 0;
+
+	if (MoveFlags(move) == MoveFlag::EnPassant)
+	{
+		occupied ^= SquareBB(MakeSquare(FileOf(to), RankOf(from)));
+		gain[0] = PIECE_VALUE[Piece::Pawn];
+	}
+	else
+	{
+		gain[0] = PIECE_VALUE[pos.pieceOn(to)];
+	}
+
+	if (IsPromotion(move))
+	{
+		attacker = PromotionPiece(move);
+		gain[0] += PIECE_VALUE[attacker] - PIECE_VALUE[Piece::Pawn];
+	}
+
+	Bitboard diagonalSliders = pos.pieces(Piece::Bishop) | pos.pieces(Piece::Queen);
+	Bitboard straightSliders = pos.pieces(Piece::Rook) | pos.pieces(Piece::Queen);
+	Bitboard attackers = pos.attackersTo(to, occupied) & occupied;
+	Color side = Opponent(pos.sideToMove());
+
+	while (d < 31)
+	{
+		Bitboard ours = attackers & pos.pieces(side);
+
+		if (!ours)
+		{
+			break;
+		}
+
+		// The piece standing on the square is captured next
+		d++;
+		gain[d] = PIECE_VALUE[attacker] - gain[d - 1];
+
+		Bitboard fromSet = 0;
+
+		for (Piece piece : CAPTURE_ORDER)
+		{
+			fromSet = ours & pos.pieces(piece);
+
+			if (fromSet)
+			{
+				attacker = piece;
+				break;
+			}
+		}
+
+		// The king cannot capture into a defended square
+		if (attacker == Piece::King && (attackers & pos.pieces(Opponent(side))))
+		{
+			d--;
+			break;
+		}
+
+		// Remove the capturing piece and uncover the sliders behind it
+		occupied ^= fromSet & (0 - fromSet);
+		attackers |= (BishopAttacks(to, occupied) & diagonalSliders) | (RookAttacks(to, occupied) & straightSliders);
+		attackers &= occupied;
+		side = Opponent(side);
+	}
+
+	// Each side recaptures only when that beats stopping before it
+	while (d > 0)
+	{
+		gain[d - 1] = -(-gain[d - 1] > gain[d] ? -gain[d - 1] : gain[d]);
+		d--;
+	}
+
+	return gain[0];
+}
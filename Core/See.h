@@ -0,0 +1,13 @@
+#ifndef SEE_H
+#define SEE_H
+
+#include "Move.h"
+#include "Position.h"
+
+// Static exchange evaluation: the material the side to move wins or loses, in centipawns, if both
+// sides keep recapturing on the destination square with their least valuable piece and each may
+// stop when going on would lose more. Pins are ignored. A quiet move scores whether the moved piece
+// can be won on its new square: 0 when it is safe there, negative when it is not. Castling counts as 0.
+int See(const Position& pos, Move move);
+
+#endif
@@ -0,0 +1,201 @@
+#include "TranspositionTable.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "Memory.h"
+#include "Numa.h"
+
+#if defined(_MSC_VER) || defined(__SSE__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+	// Packed entry: move in bits 0-15, score 16-31, eval 32-47, depth 48-55, bound 56-57, generation 58-63
+	uint64_t Pack(Move move, int score, int eval, int depth, Bound bound, unsigned generation)
+	{
+		return (uint64_t)move
+			| (uint64_t)(uint16_t)(int16_t)score << 16
+			| (uint64_t)(uint16_t)(int16_t)eval << 32
+			| (uint64_t)(uint8_t)depth << 48
+			| (uint64_t)bound << 56
+			| (uint64_t)generation << 58;
+	}
+
+	Move MoveOf(uint64_t data) { return (Move)(data & 0xFFFF); }
+	int ScoreOf(uint64_t data) { return (int16_t)(uint16_t)(data >> 16); }
+	int EvalOf(uint64_t data) { return (int16_t)(uint16_t)(data >> 32); }
+	int DepthOf(uint64_t data) { return (int8_t)(uint8_t)(data >> 48); }
+	Bound BoundOf(uint64_t data) { return Bound((data >> 56) & 3); }
+	unsigned GenerationOf(uint64_t data) { return (unsigned)(data >> 58); }
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes) : table(nullptr), clusterCount(0), generation(0)
+{
+	resize(megabytes, 1);
+}
+
+TranspositionTable::~TranspositionTable()
+{
+	AlignedFree(table);
+}
+
+bool TranspositionTable::resize(size_t megabytes, int threads, bool hugePages, bool interleave)
+{
+	size_t count = 1;
+
+	while (count * 2 * sizeof(Cluster) <= megabytes * 1024 * 1024)
+	{
+		count *= 2;
+	}
+
+	size_t bytes = count * sizeof(Cluster);
+	size_t alignment = hugePages && bytes >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : MEMORY_PAGE_SIZE;
+	Cluster* memory = (Cluster*)AlignedAlloc(alignment, bytes);
+
+	if (!memory)
+	{
+		return false;
+	}
+
+	// Both only set policies; the pages are placed when clear() first touches them
+	if (alignment == HUGE_PAGE_SIZE)
+	{
+		AdviseHugePages(memory, bytes);
+	}
+
+	if (interleave)
+	{
+		InterleaveMemory(memory, bytes);
+	}
+
+	AlignedFree(table);
+	table = memory;
+	clusterCount = count;
+	clear(threads);
+
+	return true;
+}
+
+void TranspositionTable::clear(int threads)
+{
+	std::vector<std::thread> pool;
+
+	if (threads < 1)
+	{
+		threads = 1;
+	}
+
+	size_t chunk = clusterCount / threads;
+
+	// Every thread zeroes its own slice, so the pages also end up touched by the threads that use them
+	for (int t = 0; t < threads; t++)
+	{
+		size_t first = t * chunk;
+		size_t count = t == threads - 1 ? clusterCount - first : chunk;
+
+		pool.emplace_back([this, first, count]()
+		{
+			memset((void*)(table + first), 0, count * sizeof(Cluster));
+		});
+	}
+
+	for (std::thread& thread : pool)
+	{
+		thread.join();
+	}
+
+	generation = 0;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTData& result) const
+{
+	Cluster& cluster = clusterOf(key);
+
+	for (int i = 0; i < CLUSTER_SIZE; i++)
+	{
+		uint64_t data = cluster.entries[i].data.load(std::memory_order_relaxed);
+		uint64_t check = cluster.entries[i].keyXorData.load(std::memory_order_relaxed);
+
+		if ((check ^ data) == key && data)
+		{
+			result.move = MoveOf(data);
+			result.score = ScoreOf(data);
+			result.eval = EvalOf(data);
+			result.depth = DepthOf(data);
+			result.bound = BoundOf(data);
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int score, int eval, int depth, Bound bound)
+{
+	Cluster& cluster = clusterOf(key);
+	Entry* replace = &cluster.entries[0];
+	int worst = 1 << 30;
+
+	for (int i = 0; i < CLUSTER_SIZE; i++)
+	{
+		Entry& entry = cluster.entries[i];
+		uint64_t data = entry.data.load(std::memory_order_relaxed);
+
+		if ((entry.keyXorData.load(std::memory_order_relaxed) ^ data) == key || !data)
+		{
+			// Keep the old move when this result has none, it is still the best guess for the position
+			if (move == NO_MOVE && data)
+			{
+				move = MoveOf(data);
+			}
+
+			replace = &entry;
+			break;
+		}
+
+		// Shallow entries from earlier searches go first
+		int age = (int)((generation - GenerationOf(data)) & GENERATION_MASK);
+		int value = DepthOf(data) - 8 * age;
+
+		if (value < worst)
+		{
+			worst = value;
+			replace = &entry;
+		}
+	}
+
+	uint64_t data = Pack(move, score, eval, depth, bound, generation);
+
+	replace->keyXorData.store(key ^ data, std::memory_order_relaxed);
+	replace->data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::prefetch(uint64_t key) const
+{
+#if defined(_MSC_VER) || defined(__SSE__) || defined(__x86_64__)
+	_mm_prefetch((const char*)&clusterOf(key), _MM_HINT_T0);
+#elif defined(__GNUC__)
+	__builtin_prefetch(&clusterOf(key));
+#endif
+}
+
+int TranspositionTable::hashfull() const
+{
+	int used = 0;
+	size_t samples = clusterCount < 1000 ? clusterCount : 1000;
+
+	for (size_t c = 0; c < samples; c++)
+	{
+		for (int i = 0; i < CLUSTER_SIZE; i++)
+		{
+			uint64_t data = table[c].entries[i].data.load(std::memory_order_relaxed);
+			used += data && GenerationOf(data) == generation;
+		}
+	}
+
+	return samples ? (int)(used * 1000 / (samples * CLUSTER_SIZE)) : 0;
+}
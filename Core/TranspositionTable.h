@@ -0,0 +1,80 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "Move.h"
+
+enum Bound
+{
+	BoundNone = 0,
+	BoundUpper = 1, // fail low, the score is at most this
+	BoundLower = 2, // fail high, the score is at least this
+	BoundExact = 3
+};
+
+// Scores are stored as found; mate scores must be made relative to the node by the caller
+struct TTData
+{
+	Move move;
+	int score;
+	int eval; // static evaluation of the position, so a hit saves evaluating it again
+	int depth;
+	Bound bound;
+};
+
+// Hash table of search results keyed by Zobrist key and shared by every search thread without locks.
+// Each entry stores key ^ data next to data; a torn write from two threads racing on one entry
+// leaves a pair that no longer XORs back to the key, so it reads as a miss instead of bad data.
+class TranspositionTable
+{
+public:
+	static constexpr size_t DEFAULT_SIZE_MB = 16;
+
+	explicit TranspositionTable(size_t megabytes = DEFAULT_SIZE_MB);
+	~TranspositionTable();
+	TranspositionTable(const TranspositionTable&) = delete;
+	TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+	// Rounded down to a power of two clusters. Returns false and keeps the old table if allocation fails.
+	// hugePages backs the table with transparent huge pages; interleave spreads it over the NUMA nodes.
+	bool resize(size_t megabytes, int threads, bool hugePages = false, bool interleave = false);
+	// Zeroes the table, split across threads
+	void clear(int threads);
+	// Ages existing entries so they are replaced first; call once per move, not per thread
+	void newSearch() { generation = (generation + 1) & GENERATION_MASK; }
+
+	bool probe(uint64_t key, TTData& data) const;
+	void store(uint64_t key, Move move, int score, int eval, int depth, Bound bound);
+	void prefetch(uint64_t key) const;
+
+	// Permille of sampled entries written during the current search, the UCI hashfull
+	int hashfull() const;
+
+private:
+	static constexpr int CLUSTER_SIZE = 4;
+	static constexpr unsigned GENERATION_MASK = 0x3F;
+
+	struct Entry
+	{
+		std::atomic<uint64_t> keyXorData;
+		std::atomic<uint64_t> data;
+	};
+
+	struct alignas(64) Cluster
+	{
+		Entry entries[CLUSTER_SIZE];
+	};
+
+	static_assert(sizeof(Cluster) == 64, "a cluster must fill exactly one cache line");
+
+	Cluster& clusterOf(uint64_t key) const { return table[key & (clusterCount - 1)]; }
+
+	Cluster* table;
+	size_t clusterCount;
+	unsigned generation;
+};
+
+#endif
@@ -0,0 +1,222 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "Bench.h"
+#include "Bitboard.h"
+#include "Perft.h"
+#include "Position.h"
+
+namespace
+{
+	const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+	// Reference counts from the Chess Programming Wiki perft results page
+	struct ReferencePosition
+	{
+		const char* name;
+		const char* fen;
+		uint64_t nodes[6]; // depth 1 to 6, 0 when not listed
+	};
+
+	const ReferencePosition SUITE[] =
+	{
+		{ "startpos", START_FEN,
+			{ 20, 400, 8902, 197281, 4865609, 119060324 } },
+		{ "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+			{ 48, 2039, 97862, 4085603, 193690690, 0 } },
+		{ "position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+			{ 14, 191, 2812, 43238, 674624, 11030083 } },
+		{ "position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+			{ 6, 264, 9467, 422333, 15833292, 0 } },
+		{ "position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+			{ 44, 1486, 62379, 2103487, 89941194, 0 } },
+		{ "position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+			{ 46, 2079, 89890, 3894594, 164075551, 0 } }
+	};
+
+	void PrintUsage()
+	{
+		printf("usage: perft [-t threads] [-d] <depth> [fen]\n");
+		printf("       perft [-t threads] suite [max depth]\n");
+		printf("       perft [-t threads] [-n] [-l] smp [ms per position] [hash MB]\n");
+		printf("       perft select [depth]\n");
+		printf("       perft [-t threads] stats [depth] [fen]\n");
+		printf("       perft nnue <network file>\n");
+		printf("       perft nnue random <network file> [seed]\n");
+		printf("  -t  threads to split the root moves across, or the most search threads for smp (default: all cores)\n");
+		printf("  -d  divide, print the node count below every root move\n");
+		printf("  -n  smp: bind the search threads and their memory to NUMA nodes\n");
+		printf("  -l  smp: back the hash table with large (huge) pages\n");
+	}
+
+	void PrintResult(const PerftResult& result)
+	{
+		double nps = result.seconds > 0 ? result.nodes / result.seconds : 0;
+		printf("nodes %llu time %.3fs nps %.0f\n", (unsigned long long)result.nodes, result.seconds, nps);
+	}
+
+	// Runs every reference position up to maxDepth and returns the number of mismatches
+	int RunSuite(int maxDepth, int threads)
+	{
+		int failures = 0;
+		uint64_t totalNodes = 0;
+		double totalSeconds = 0;
+
+		for (const ReferencePosition& ref : SUITE)
+		{
+			Position pos;
+			pos.setFen(ref.fen);
+
+			for (int depth = 1; depth <= maxDepth && depth <= 6 && ref.nodes[depth - 1]; depth++)
+			{
+				PerftResult result = RunPerft(pos, depth, threads, false);
+				bool ok = result.nodes == ref.nodes[depth - 1];
+
+				printf("%-10s depth %d  %12llu  %s\n", ref.name, depth, (unsigned long long)result.nodes,
+					ok ? "ok" : "MISMATCH");
+
+				failures += ok ? 0 : 1;
+				totalNodes += result.nodes;
+				totalSeconds += result.seconds;
+			}
+		}
+
+		PerftResult total = { totalNodes, totalSeconds };
+		PrintResult(total);
+		printf("%s\n", failures ? "FAILED" : "all counts match");
+
+		return failures;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int threads = (int)std::thread::hardware_concurrency();
+	bool divide = false;
+	bool numa = false;
+	bool hugePages = false;
+	int arg = 1;
+
+	for (; arg < argc && argv[arg][0] == '-'; arg++)
+	{
+		if (strcmp(argv[arg], "-d") == 0)
+		{
+			divide = true;
+		}
+		else if (strcmp(argv[arg], "-n") == 0)
+		{
+			numa = true;
+		}
+		else if (strcmp(argv[arg], "-l") == 0)
+		{
+			hugePages = true;
+		}
+		else if (strcmp(argv[arg], "-t") == 0 && arg + 1 < argc)
+		{
+			threads = atoi(argv[++arg]);
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (threads < 1)
+	{
+		threads = 1;
+	}
+
+	if (arg >= argc)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	InitBitboards();
+
+	if (strcmp(argv[arg], "suite") == 0)
+	{
+		int maxDepth = arg + 1 < argc ? atoi(argv[arg + 1]) : 4;
+		return RunSuite(maxDepth, threads) == 0 ? 0 : 1;
+	}
+
+	// Search speed with 1, 2, 4 ... threads, to size the hardware for Lazy SMP
+	if (strcmp(argv[arg], "smp") == 0)
+	{
+		int64_t moveTime = arg + 1 < argc ? atoll(argv[arg + 1]) : 2000;
+		size_t hash = arg + 2 < argc ? (size_t)atoll(argv[arg + 2]) : 256;
+
+		BenchThreads(threads, moveTime, hash, numa, hugePages);
+		return 0;
+	}
+
+	// Time to depth with each selective search option switched off in turn
+	if (strcmp(argv[arg], "select") == 0)
+	{
+		BenchSelectivity(arg + 1 < argc ? atoi(argv[arg + 1]) : 9);
+		return 0;
+	}
+
+	// Search counters: hashing, move ordering and pruning rates of one search
+	if (strcmp(argv[arg], "stats") == 0)
+	{
+		int depth = arg + 1 < argc ? atoi(argv[arg + 1]) : 12;
+		std::string fen;
+
+		for (arg += 2; arg < argc; arg++)
+		{
+			fen += fen.empty() ? "" : " ";
+			fen += argv[arg];
+		}
+
+		Position pos;
+
+		if (!pos.setFen(fen.empty() ? START_FEN : fen))
+		{
+			printf("invalid fen: %s\n", fen.c_str());
+			return 1;
+		}
+
+		BenchStats(pos, depth, threads);
+		return 0;
+	}
+
+	// Network kernels: speed of each instruction set and agreement with the scalar code
+	if (strcmp(argv[arg], "nnue") == 0 && arg + 2 < argc && strcmp(argv[arg + 1], "random") == 0)
+	{
+		unsigned seed = arg + 3 < argc ? (unsigned)atoi(argv[arg + 3]) : 1;
+		return WriteRandomNnue(argv[arg + 2], seed) ? 0 : 1;
+	}
+
+	if (strcmp(argv[arg], "nnue") == 0 && arg + 1 < argc)
+	{
+		return BenchNnue(argv[arg + 1]) == 0 ? 0 : 1;
+	}
+
+	int depth = atoi(argv[arg++]);
+	std::string fen;
+
+	// The FEN fields arrive as separate arguments unless quoted
+	for (; arg < argc; arg++)
+	{
+		fen += fen.empty() ? "" : " ";
+		fen += argv[arg];
+	}
+
+	Position pos;
+
+	if (!pos.setFen(fen.empty() ? START_FEN : fen))
+	{
+		printf("invalid fen: %s\n", fen.c_str());
+		return 1;
+	}
+
+	PerftResult result = RunPerft(pos, depth, threads, divide);
+	PrintResult(result);
+
+	return 0;
+}
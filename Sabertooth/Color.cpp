@@ -1,5 +0,0 @@
-enum Color
-{
-	Black = 1,
-	White = 2
-};
\ No newline at end of file
@@ -0,0 +1,288 @@
+#include <GL/glew.h>
+#include <iostream>
+
+#include <stb_image.h>
+#include "Game.h"
+
+using namespace std;
+
+namespace
+{
+	const int sumTilesHeigth = NUM_ROWS * TILE_HEIGHT;
+
+	// Carrega a textura da pea, retorna 0 se a imagem no for encontrada
+	GLuint LoadTexture(bool isBlack, Piece piece)
+	{
+		const char* img = "";
+
+		switch (piece)
+		{
+		case Piece::Bishop:
+			img = isBlack ? "..\\Images\\BlackBishop.png" : "..\\Images\\WhiteBishop.png";
+			break;
+
+		case Piece::King:
+			img = isBlack ? "..\\Images\\BlackKing.png" : "..\\Images\\WhiteKing.png";
+			break;
+
+		case Piece::Knight:
+			img = isBlack ? "..\\Images\\BlackKnight.png" : "..\\Images\\WhiteKnight.png";
+			break;
+
+		case Piece::Pawn:
+			img = isBlack ? "..\\Images\\BlackPawn.png" : "..\\Images\\WhitePawn.png";
+			break;
+
+		case Piece::Queen:
+			img = isBlack ? "..\\Images\\BlackQueen.png" : "..\\Images\\WhiteQueen.png";
+			break;
+
+		case Piece::Rook:
+			img = isBlack ? "..\\Images\\BlackRook.png" : "..\\Images\\WhiteRook.png";
+			break;
+
+		default:
+			break;
+		}
+
+		GLuint texture;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_LINEAR);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		int width, height, nrChannels;
+		unsigned char* data = stbi_load(img, &width, &height, &nrChannels, 0);
+
+		if (data)
+		{
+			nrChannels == 3
+				? glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data)
+				: glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+
+			glGenerateMipmap(GL_TEXTURE_2D);
+			stbi_image_free(data);
+
+			return texture;
+		}
+
+		std::cout << "Failed to load texture" << std::endl;
+		glDeleteTextures(1, &texture);
+
+		return 0;
+	}
+
+	// Carrega as sprites e retorna o handle da pea no registro (0 se a textura no carregar)
+	int LoadImage(PieceRegistry& sprites, bool isBlack, Piece piece)
+	{
+		GLuint texture = LoadTexture(isBlack, piece);
+
+		if (texture == 0)
+		{
+			return 0;
+		}
+
+		GameObject gameObj = GameObject::GameObject(0, isBlack, texture, piece);
+
+		return sprites.add(gameObj);
+	}
+
+	// Define os vertices das sprites. E faz a associao dos VAO e os VBO
+	void DefineGeometry(GameObject& go)
+	{
+		GLuint VAO, VBO;
+
+		glGenVertexArrays(1, &VAO);
+
+		glGenBuffers(1, &VBO);
+
+		glBindVertexArray(VAO);
+
+		go.setVao(VAO);
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+		GLfloat vertices[] = {
+			// positions	// texture coords
+			0.0f, 40.0f, 	1.0, 1.0f,
+			0.0f, 0.0f, 	1.0f, 0.0f,
+			30.0f, 40.0f, 	0.0f, 1.0f,
+
+			30.0f, 40.0f, 	0.0, 1.0f,
+			0.0f, 0.0f, 	1.0f, 0.0f,
+			30.0f, 0.0f, 	0.0f, 0.0f,
+		};
+
+		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)0);
+
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)(2 * sizeof(float)));
+
+		glEnableVertexAttribArray(0);
+
+		glEnableVertexAttribArray(1);
+
+		glBindVertexArray(0);
+	}
+}
+
+void DiamondDrawCalculation(float& x, float& y, int row, int col)
+{
+	x = row * (TILE_WIDTH / 2.0f) + col * (TILE_WIDTH / 2.0f);
+	y = row * (TILE_HEIGHT / 2.0f) - col * (TILE_HEIGHT / 2.0f) + sumTilesHeigth / 2.0f - (TILE_HEIGHT / 2.0f);
+}
+
+Game::Game()
+{
+	createMatrixColors();
+	configSprites();
+}
+
+// Cria o diamond map
+void Game::createMatrixColors()
+{
+	int idTile = 1;
+
+	for (int row = 0; row < NUM_ROWS; row++)
+	{
+		for (int col = 0; col < NUM_COLS; col++)
+		{
+			float x0, y0;
+
+			DiamondDrawCalculation(x0, y0, row, col);
+
+			Tile t = Tile(idTile++, x0, y0, TILE_HEIGHT, TILE_WIDTH);
+
+			t.generateColor(row, col);
+
+			matrixColors[row][col] = t;
+		}
+	}
+}
+
+// Cria uma sprite para cada pea da posio inicial
+void Game::configSprites()
+{
+	for (Bitboard occupied = state.board().occupied(); occupied; )
+	{
+		int sq = PopLsb(occupied);
+
+		configPiece(RowOf(sq), ColOf(sq), state.board().colorOn(sq) == Color::Black, state.board().pieceOn(sq));
+	}
+}
+
+// Faz a leitura e define o vao das sprites e as vincula com seu tile inicial
+void Game::configPiece(int row, int col, bool isBlack, Piece piece)
+{
+	int handle = LoadImage(sprites, isBlack, piece);
+
+	if (handle == 0)
+	{
+		return;
+	}
+
+	DefineGeometry(sprites.get(handle));
+
+	// seta o handle da pea no tile, para que a sprite seja encontrada a partir da casa
+	matrixColors[row][col].setIdPiece(handle);
+}
+
+void Game::markTile(int r, int c, bool canPlay)
+{
+	matrixColors[r][c].canPlay = canPlay;
+	matrixColors[r][c].generateColor(r, c);
+}
+
+void Game::markSelection()
+{
+	int selected = state.selectedSquare();
+
+	for (int row = 0; row < NUM_ROWS; row++)
+	{
+		for (int col = 0; col < NUM_COLS; col++)
+		{
+			matrixColors[row][col].isSelected = SquareOf(row, col) == selected;
+			markTile(row, col, SquareOf(row, col) == selected);
+		}
+	}
+
+	for (Move move : state.selectedMoves())
+	{
+		markTile(RowOf(ToSquare(move)), ColOf(ToSquare(move)), true);
+	}
+}
+
+void Game::moveSprites(Move move)
+{
+	int from = FromSquare(move);
+	int to = ToSquare(move);
+	// O lance j foi jogado, ento quem jogou  quem no tem a vez
+	bool isBlack = state.board().sideToMove() == Color::White;
+
+	if (IsCapture(move))
+	{
+		int capturedSquare = MoveFlags(move) == MoveFlag::EnPassant ? (isBlack ? to + 8 : to - 8) : to;
+
+		sprites.remove(tileOf(capturedSquare).idPiece);
+		tileOf(capturedSquare).setIdPiece(0);
+	}
+
+	if (IsCastle(move))
+	{
+		int rookFrom, rookTo;
+		CastlingRookSquares(move, rookFrom, rookTo);
+
+		tileOf(rookTo).setIdPiece(tileOf(rookFrom).idPiece);
+		tileOf(rookFrom).setIdPiece(0);
+	}
+
+	tileOf(to).setIdPiece(tileOf(from).idPiece);
+	tileOf(from).setIdPiece(0);
+
+	if (IsPromotion(move) && sprites.contains(tileOf(to).idPiece))
+	{
+		GameObject& sprite = sprites.get(tileOf(to).idPiece);
+		GLuint texture = LoadTexture(isBlack, PromotionPiece(move));
+
+		sprite.setPiece(PromotionPiece(move));
+
+		if (texture != 0)
+		{
+			GLuint pawnTexture = sprite.tid;
+			glDeleteTextures(1, &pawnTexture);
+			sprite.setTid(texture);
+		}
+	}
+}
+
+void Game::updateEngine()
+{
+	Move move = state.updateEngine();
+
+	if (move != NO_MOVE)
+	{
+		moveSprites(move);
+	}
+}
+
+void Game::selectTile(int rowClick, int columnClick)
+{
+	if (rowClick < 0 || columnClick < 0 || columnClick >= NUM_COLS || rowClick >= NUM_ROWS)
+	{
+		return;
+	}
+
+	Move move = state.click(SquareOf(rowClick, columnClick));
+
+	if (move != NO_MOVE)
+	{
+		moveSprites(move);
+	}
+
+	markSelection();
+}
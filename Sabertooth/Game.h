@@ -0,0 +1,57 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include "Match.h"
+#include "PieceRegistry.h"
+#include "Tile.h"
+
+// Altura e largura dos tiles
+constexpr auto TILE_WIDTH = 80;
+constexpr auto TILE_HEIGHT = 40;
+constexpr auto NUM_COLS = 8;
+constexpr auto NUM_ROWS = 8;
+
+// Clculo da posio do tile, tambm utilizado para posicionar as sprites no tabuleiro
+void DiamondDrawCalculation(float& x, float& y, int row, int col);
+
+// A partida na janela: tiles e sprites. Regras, seleo, vez, resultado e busca do computador ficam
+// no Match, que no usa OpenGL; as sprites acompanham cada lance que ele informa. Precisa de um
+// contexto OpenGL ativo.
+class Game
+{
+public:
+	Game();
+
+	// Estado da partida, tambm usado para configurar o computador
+	Match& match() { return state; }
+	const Match& match() const { return state; }
+
+	// Clique do jogador numa casa do tabuleiro
+	void selectTile(int row, int col);
+	// Chamado a cada frame: deixa o computador jogar e move as sprites quando ele joga
+	void updateEngine();
+
+	const Tile& tile(int row, int col) const { return matrixColors[row][col]; }
+	const PieceRegistry& pieces() const { return sprites; }
+
+private:
+	void createMatrixColors();
+	void configSprites();
+	void configPiece(int row, int col, bool isBlack, Piece piece);
+	void markTile(int r, int c, bool canPlay);
+	// Marca a pea selecionada e os destinos das jogadas dela, desmarcando o resto
+	void markSelection();
+	Tile& tileOf(int sq) { return matrixColors[RowOf(sq)][ColOf(sq)]; }
+	// Leva as sprites junto com um lance j jogado: captura, roque e promoo
+	void moveSprites(Move move);
+
+	// Tiles
+	Tile matrixColors[NUM_ROWS][NUM_COLS];
+
+	// Peas do jogo, acessadas pelo handle guardado no tile
+	PieceRegistry sprites;
+
+	Match state;
+};
+
+#endif
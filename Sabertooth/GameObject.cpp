@@ -5,16 +5,12 @@ GameObject::GameObject()
 
 }
 
-GameObject::GameObject(int id, bool isBlack, GLuint tid, Piece piece, vector<Movement>movements, int row, int col)
+GameObject::GameObject(int id, bool isBlack, GLuint tid, Piece piece)
 {
 	setId(id);
 	setTid(tid);
 	setPiece(piece);
-	setMovements(movements);
 	setColor(isBlack ? Color::Black : Color::White);
-	setCurrentCol(col);
-	setCurrentRow(row);
-	this->isFirstMove = true;
 }
 
 void GameObject::setVao(GLuint value)
@@ -37,22 +33,7 @@ void GameObject::setPiece(Piece value)
 	this->piece = value;
 }
 
-void GameObject::setMovements(vector<Movement>value)
-{
-	this->movements = value;
-}
-
 void GameObject::setColor(Color color)
 {
 	this->color = color;
-}
-
-void GameObject::setCurrentCol(int value)
-{
-	this->currentCol = value;
-}
-
-void GameObject::setCurrentRow(int value)
-{
-	this->currentRow = value;
 }
\ No newline at end of file
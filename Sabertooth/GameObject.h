@@ -1,8 +1,10 @@
+#ifndef GAMEOBJECT_H
+#define GAMEOBJECT_H
+
 #include <GL\glew.h>
 #include "Piece.cpp"
 #include <iostream>
 #include <vector>
-#include "Movement.cpp"
 #include "Color.cpp"
 
 using namespace std;
@@ -11,18 +13,15 @@ class GameObject
 {
 public:
 	GameObject();
-	GameObject(int id, bool isBlack, GLuint tid, Piece piece, vector<Movement>movements, int row, int col);
+	GameObject(int id, bool isBlack, GLuint tid, Piece piece);
 	void setVao(GLuint value);
 	void setId(int value);
 	void setTid(GLuint value);
 	void setPiece(Piece value);
-	void setMovements(vector<Movement>movements);
 	void setColor(Color value);
-	void setCurrentRow(int value);
-	void setCurrentCol(int value);
-	int vao, id, tid, currentRow, currentCol;
-	bool isFirstMove;
+	int vao, id, tid;
 	Piece piece;
-	vector<Movement>movements;
 	Color color;
-};
\ No newline at end of file
+};
+
+#endif
\ No newline at end of file
@@ -1,12 +0,0 @@
-enum Movement
-{
-	North = 1,
-	South = 2,
-	West = 3,
-	East = 4,
-	Northeast = 5,
-	Southeast = 6,
-	Northwest = 7,
-	Southwest = 8,
-	InL = 9 // Movimento do cavalo
-};
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "PieceRegistry.h"
+
+PieceRegistry::PieceRegistry()
+{
+	freeHead = -1;
+}
+
+int PieceRegistry::add(const GameObject& piece)
+{
+	int slot;
+
+	if (freeHead >= 0)
+	{
+		slot = freeHead;
+		freeHead = slots[slot].dense;
+	}
+	else
+	{
+		slot = (int)slots.size();
+		slots.push_back({ 1, 0 });
+	}
+
+	slots[slot].dense = (int)objects.size();
+	objects.push_back(piece);
+	owners.push_back(slot);
+
+	int handle = (slots[slot].generation << 16) | slot;
+	objects.back().setId(handle);
+
+	return handle;
+}
+
+void PieceRegistry::remove(int handle)
+{
+	if (!contains(handle))
+	{
+		return;
+	}
+
+	int slot = handle & SLOT_MASK;
+	int dense = slots[slot].dense;
+	int last = (int)objects.size() - 1;
+
+	// Keeps objects packed by moving the last entry into the hole
+	if (dense != last)
+	{
+		objects[dense] = objects[last];
+		owners[dense] = owners[last];
+		slots[owners[dense]].dense = dense;
+	}
+
+	objects.pop_back();
+	owners.pop_back();
+
+	slots[slot].generation = slots[slot].generation % MAX_GENERATION + 1;
+	slots[slot].dense = freeHead;
+	freeHead = slot;
+}
+
+bool PieceRegistry::contains(int handle) const
+{
+	int slot = handle & SLOT_MASK;
+
+	return handle > 0 && slot < (int)slots.size() && slots[slot].generation == (handle >> 16);
+}
+
+void PieceRegistry::clear()
+{
+	slots.clear();
+	objects.clear();
+	owners.clear();
+	freeHead = -1;
+}
@@ -0,0 +1,43 @@
+#ifndef PIECEREGISTRY_H
+#define PIECEREGISTRY_H
+
+#include <vector>
+#include "GameObject.h"
+
+// Slot map holding the sprites of the pieces on the board. A handle is (generation << 16) | slot:
+// it stays valid while the piece lives, whatever is removed around it, and stops resolving once
+// the piece is captured. Handle 0 is never issued, so it can mean "no piece".
+class PieceRegistry
+{
+public:
+	PieceRegistry();
+	int add(const GameObject& piece);
+	void remove(int handle);
+	bool contains(int handle) const;
+	void clear();
+
+	// Handle must be valid, see contains
+	GameObject& get(int handle) { return objects[slots[handle & SLOT_MASK].dense]; }
+	const GameObject& get(int handle) const { return objects[slots[handle & SLOT_MASK].dense]; }
+
+	int size() const { return (int)objects.size(); }
+	std::vector<GameObject>::iterator begin() { return objects.begin(); }
+	std::vector<GameObject>::iterator end() { return objects.end(); }
+
+private:
+	static const int SLOT_MASK = 0xFFFF;
+	static const int MAX_GENERATION = 0x7FFF;
+
+	struct Slot
+	{
+		int generation;
+		int dense; // index in objects, or the next free slot while unused
+	};
+
+	std::vector<Slot> slots;
+	std::vector<GameObject> objects;
+	std::vector<int> owners; // slot of each entry in objects
+	int freeHead;
+};
+
+#endif
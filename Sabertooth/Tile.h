@@ -1,3 +1,6 @@
+#ifndef TILE_H
+#define TILE_H
+
 #include <glm/glm.hpp>
 
 class Tile {
@@ -18,4 +21,6 @@ public:
 	Tile(int id, float x0, float y0, float th, float tw);
 	void generateColor(int row, int col);
 	void setIdPiece(int value);
-};
\ No newline at end of file
+};
+
+#endif
@@ -6,48 +6,30 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
-#include "Tile.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
-#include "GameObject.h"
+#include "Game.h"
+#include "Nnue.h"
+#include "NnueKernels.h"
+#include "SearchThread.h"
 
 using namespace std;
 
 #pragma region Properties
 
-// Altura e largura dos tiles
-constexpr auto TILE_WIDTH = 80;
-constexpr auto TILE_HEIGHT = 40;
-constexpr auto NUM_COLS = 8;
-constexpr auto NUM_ROWS = 8;
-
 // Constantes para tamanho de tela
 const int WIDTH = NUM_ROWS * TILE_WIDTH;
 const int HEIGHT = NUM_COLS * TILE_HEIGHT;
 
-bool canPlayWhite = true;
-bool canPlayBlack = false;
-
-// Tiles
-Tile matrixColors[NUM_ROWS][NUM_COLS] = {};
-
-// Peas do jogo
-vector<GameObject> whiteSprites;
-vector<GameObject> blackSprites;
+// Oramento de cada lance do computador: profundidade, tempo em milissegundos e ns (0 = sem limite)
+const SearchLimits ENGINE_LIMITS = { 0, 1000, 0 };
+// Tamanho da tabela de transposio em MB
+const size_t ENGINE_HASH_MB = 64;
+// Rede neural opcional; sem o arquivo a avaliao manual  usada
+const char* ENGINE_NNUE_FILE = "sabertooth.nnue";
 
 const int sumTilesHeigth = NUM_ROWS * TILE_HEIGHT;
-
-// Array com as posies que podero ser jogadas, serve para controlar o movimento da pea.
-// Exemplo: se o jogador selecionar a pea bispo, todos os provveis tiles para onde o bispode pode se mover estaro aqui.
-vector<pair<int, int>> selectedPositions;
-
-glm::mat4 matrix = glm::mat4(1);
-
-int lastSelectedColumn = -1;
-int lastSelectedRow = -1;
-
-bool someoneWin;
 #pragma endregion
 
 int ConnectVertex(const char* v_shader, const char* f_shader)
@@ -70,84 +52,6 @@ int ConnectVertex(const char* v_shader, const char* f_shader)
 
 #pragma region Sprite
 
-// Carrega as sprites
-void LoadImage(int id, bool isBlack, int row, int col, Piece piece)
-{
-	const char* img = "";
-	vector<Movement> pieceMovement;
-
-	switch (piece)
-	{
-	case Piece::Bishop:
-		img = isBlack ? "..\\Images\\BlackBishop.png" : "..\\Images\\WhiteBishop.png";
-		pieceMovement = { Movement::Northwest, Movement::Northeast, Movement::Southeast, Movement::Southwest };
-		break;
-
-	case Piece::King:
-		img = isBlack ? "..\\Images\\BlackKing.png" : "..\\Images\\WhiteKing.png";
-		pieceMovement = { Movement::Northwest, Movement::Northeast, Movement::Southeast, Movement::Southwest, Movement::East, Movement::North, Movement::South, Movement::West };
-		break;
-
-	case Piece::Knight:
-		img = isBlack ? "..\\Images\\BlackKnight.png" : "..\\Images\\WhiteKnight.png";
-		pieceMovement = { Movement::InL };
-		break;
-
-	case Piece::Pawn:
-		img = isBlack ? "..\\Images\\BlackPawn.png" : "..\\Images\\WhitePawn.png";
-		pieceMovement = { isBlack ? Movement::North : Movement::South };
-		break;
-
-	case Piece::Queen:
-		img = isBlack ? "..\\Images\\BlackQueen.png" : "..\\Images\\WhiteQueen.png";
-		pieceMovement = { Movement::Northwest, Movement::Northeast, Movement::Southeast, Movement::Southwest, Movement::East, Movement::North, Movement::South, Movement::West };
-		break;
-
-	case Piece::Rook:
-		img = isBlack ? "..\\Images\\BlackRook.png" : "..\\Images\\WhiteRook.png";
-		pieceMovement = { Movement::North, Movement::South, Movement::East, Movement::West };
-		break;
-	}
-
-	GLuint texture;
-	glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_2D, texture);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_LINEAR);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	int width, height, nrChannels;
-	unsigned char* data = stbi_load(img, &width, &height, &nrChannels, 0);
-
-	if (data)
-	{
-		nrChannels == 3
-			? glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data)
-			: glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-
-		glGenerateMipmap(GL_TEXTURE_2D);
-		stbi_image_free(data);
-
-		GameObject gameObj = GameObject::GameObject(id, isBlack, texture, piece, pieceMovement, isBlack ? row : 7 - row, col);
-
-		isBlack ? blackSprites.push_back(gameObj) : whiteSprites.push_back(gameObj);
-	}
-	else
-	{
-		std::cout << "Failed to load texture" << std::endl;
-	}
-}
-
-// Clcuo da posio do tile, tambm utilizado para posicionar as sprites no tabuleiro
-void DiamondDrawCalculation(float& x, float& y, int row, int col)
-{
-	x = row * (TILE_WIDTH / 2.0f) + col * (TILE_WIDTH / 2.0f);
-	y = row * (TILE_HEIGHT / 2.0f) - col * (TILE_HEIGHT / 2.0f) + sumTilesHeigth / 2.0f - (TILE_HEIGHT / 2.0f);
-}
-
 // faz o bind das textura e desenha a geometria
 void Render(GLuint vao, GLuint texture, int sp)
 {
@@ -166,10 +70,10 @@ void Transform(glm::mat4& mt, unsigned int& tl, int sp, float x, float y, float
 }
 
 // Atribuis o offsetx e o offsetY por layer e gameobject
-void DefineOffsetAndRender(int sp, float offsetx, float offsety, float z, glm::mat4 mt, GameObject& go, unsigned int& tl)
+void DefineOffsetAndRender(int sp, float offsetx, float offsety, float z, glm::mat4 mt, const GameObject& go, int row, int col, unsigned int& tl)
 {
 	float x, y;
-	DiamondDrawCalculation(x, y, go.currentRow, go.currentCol);
+	DiamondDrawCalculation(x, y, row, col);
 
 	Transform(mt, tl, sp, x + 25, y - 15, 0.0f);
 
@@ -180,140 +84,24 @@ void DefineOffsetAndRender(int sp, float offsetx, float offsety, float z, glm::m
 	Render(go.vao, go.tid, sp);
 }
 
-// Define os vertices das sprites. E faz a associao dos VAO e os VBO
-void DefineGeometry(int id, GameObject& go)
-{
-	GLuint VAO, VBO;
-
-	glGenVertexArrays(1, &VAO);
-
-	glGenBuffers(1, &VBO);
-
-	glBindVertexArray(VAO);
-
-	go.setVao(VAO);
-
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-	GLfloat vertices[] = {
-		// positions	// texture coords
-		0.0f, 40.0f, 	1.0, 1.0f,
-		0.0f, 0.0f, 	1.0f, 0.0f,
-		30.0f, 40.0f, 	0.0f, 1.0f,
-
-		30.0f, 40.0f, 	0.0, 1.0f,
-		0.0f, 0.0f, 	1.0f, 0.0f,
-		30.0f, 0.0f, 	0.0f, 0.0f,
-	};
-
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)0);
-
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)(2 * sizeof(float)));
-
-	glEnableVertexAttribArray(0);
-
-	glEnableVertexAttribArray(1);
-
-	glBindVertexArray(0);
-}
+#pragma endregion
 
-// Faz a leitura e define o vao das sprites e as vincula com seu tile inicial
-void ConfigPiece(int id, int row, int col, bool isBlack, Piece piece)
+// Progresso da busca no console: uma linha por iterao
+void PrintSearchInfo(const SearchResult& result)
 {
-	LoadImage(id, isBlack, row, col, piece);
-
-	GameObject& sprite = isBlack ? blackSprites.back() : whiteSprites.back();
+	cout << "depth " << result.depth << " score " << result.score << " nodes " << result.nodes << " time " << result.elapsed << " pv";
 
-	DefineGeometry(id, isBlack ? blackSprites.back() : whiteSprites.back());
-
-	// seta o id da pea no tile, para que seja utilizado na lgica do jogo
-	if (isBlack) {
-
-		matrixColors[row][col].setIdPiece(sprite.id);
-	}
-	else
+	for (int i = 0; i < result.pvLength; i++)
 	{
-		int rowBlack = 7 - row;
-		matrixColors[rowBlack][col].setIdPiece(sprite.id);
+		cout << " " << MoveToString(result.pv[i]);
 	}
-}
-
-// Configura as sprites, fazendo a leitura e definindo a geometria
-void ConfigSprites()
-{
-	int idSprite = 0;
-
-	for (size_t row = 0; row < 2; row++)
-	{
-		for (size_t col = 0; col < NUM_ROWS; col++)
-		{
-			Piece p;
-			int idWhite = ++idSprite;
-			int idBlack = idWhite + 16;
 
-			if (row > 0)
-			{
-				p = Piece::Pawn;
-			}
-			else
-			{
-				switch (idSprite)
-				{
-				case 1:
-				case 8:
-					p = Piece::Rook;
-					break;
-				case 2:
-				case 7:
-					p = Piece::Knight;
-					break;
-				case 3:
-				case 6:
-					p = Piece::Bishop;
-					break;
-				case 4:
-					p = Piece::King;
-					break;
-				case 5:
-					p = Piece::Queen;
-					break;
-				}
-			}
-
-			ConfigPiece(idWhite, row, col, false, p);
-			ConfigPiece(idBlack, row, col, true, p);
-		}
-	}
+	// Taxas de acerto e de corte, somadas entre as threads
+	cout << " " << StatsSummary(result) << endl;
 }
 
-#pragma endregion
-
 #pragma region DiamondMap
-// Cria o diamond map
-void CreateMatrixColors()
-{
-	int idTile = 1;
-
-	for (int row = 0; row < NUM_ROWS; row++)
-	{
-		for (int col = 0; col < NUM_COLS; col++)
-		{
-			float x0, y0;
-
-			DiamondDrawCalculation(x0, y0, row, col);
-
-			Tile t = Tile(idTile++, x0, y0, TILE_HEIGHT, TILE_WIDTH);
-
-			t.generateColor(row, col);
-
-			matrixColors[row][col] = t;
-		}
-	}
-}
-
-void RenderDiamondMap(glm::mat4 matrix, int sp)
+void RenderDiamondMap(const Game& game, glm::mat4 matrix, int sp)
 {
 	for (int i = 0; i < NUM_ROWS; i++)
 	{
@@ -330,7 +118,7 @@ void RenderDiamondMap(glm::mat4 matrix, int sp)
 			//define aonde desenhar
 			glUniformMatrix4fv(glGetUniformLocation(sp, "matrix_OBJ"), 1, GL_FALSE, glm::value_ptr(matrix));
 
-			Tile tile = matrixColors[i][j];
+			const Tile& tile = game.tile(i, j);
 
 			glUniform3fv(glGetUniformLocation(sp, "colorValues"), 1, glm::value_ptr(tile.colorsRGB));
 
@@ -352,520 +140,18 @@ void DiamondClickCalculation(float xPos, float yPos, int& row, int& col) {
 	col = (int)columnClick;
 }
 
-GameObject GetPiece(int id)
-{
-	GameObject retorno;
-
-	for each (GameObject white in whiteSprites)
-	{
-		if (white.id == id)
-		{
-			return white;
-		}
-	}
-
-	if (retorno.id == 0)
-	{
-		for each (GameObject black in blackSprites)
-		{
-			if (black.id == id)
-			{
-				return black;
-			}
-		}
-	}
-
-	return retorno;
-}
-
-// adiciona as posies que o player pode jogar
-void AddSelectedPosition(int r, int c)
-{
-	std::pair<int, int> p = make_pair(r, c);
-	selectedPositions.push_back(p);
-}
-
-void markTile(int r, int c, bool canPlay, bool add)
-{
-	matrixColors[r][c].canPlay = canPlay;
-	matrixColors[r][c].generateColor(r, c);
-
-	if (add)
-	{
-		AddSelectedPosition(r, c);
-	}
-}
-
-void markMovements(int rowClick, int columnClick, GameObject piece)
-{
-	for each (Movement movement in piece.movements)
-	{
-		if (movement == Movement::North)
-		{
-			int moveNorth = NUM_ROWS;
-
-			if (piece.piece == Piece::Pawn)
-			{
-				// Define um movimento a mais, pois a condio do for  < e no <=
-				moveNorth = piece.isFirstMove ? 3 : 2;
-
-				// Regra para ataque do pio
-				if (rowClick + 1 < NUM_ROWS
-					&& columnClick + 1 < NUM_COLS
-					&& matrixColors[rowClick + 1][columnClick + 1].idPiece > 0
-					&& GetPiece(matrixColors[rowClick + 1][columnClick + 1].idPiece).color != piece.color)
-				{
-					markTile(rowClick + 1, columnClick + 1, true, true);
-				}
-
-				if (rowClick + 1 < NUM_ROWS
-					&& columnClick - 1 >= 0
-					&& matrixColors[rowClick + 1][columnClick - 1].idPiece > 0
-					&& GetPiece(matrixColors[rowClick + 1][columnClick - 1].idPiece).color != piece.color)
-				{
-					markTile(rowClick + 1, columnClick - 1, true, true);
-				}
-			}
-
-			if (piece.piece == Piece::King)
-			{
-				moveNorth = 2;
-			}
-
-			for (size_t i = 1; i < moveNorth; i++)
-			{
-				if (rowClick + i < NUM_ROWS)
-				{
-					GameObject nextTile = GetPiece(matrixColors[rowClick + i][columnClick].idPiece);
-
-					if (nextTile.color == piece.color || (piece.piece == Piece::Pawn && nextTile.color != piece.color && nextTile.color != NULL))
-					{
-						break;
-					}
-
-					markTile(rowClick + i, columnClick, true, true);
-
-					if (nextTile.color != piece.color && nextTile.color != NULL)
-					{
-						break;
-					}
-				}
-			}
-		}
-		else if (movement == Movement::East)
-		{
-			int moveEast = NUM_COLS;
-
-			if (piece.piece == Piece::King)
-			{
-				moveEast = 1;
-			}
-
-			for (size_t i = 1; i <= moveEast; i++)
-			{
-				if (columnClick - i < NUM_ROWS)
-				{
-					GameObject nextTile = GetPiece(matrixColors[rowClick][columnClick - i].idPiece);
-
-					if (nextTile.color == piece.color)
-					{
-						break;
-					}
-
-					markTile(rowClick, columnClick - i, true, true);
-
-					if (nextTile.color != piece.color && nextTile.color != NULL)
-					{
-						break;
-					}
-				}
-			}
-		}
-		else if (movement == Movement::InL)
-		{
-			// Sobe para o oeste e para o norte
-			if (rowClick + 1 < NUM_COLS
-				&& columnClick + 2 < NUM_COLS
-				&& GetPiece(matrixColors[rowClick + 1][columnClick + 2].idPiece).color != piece.color)
-			{
-				markTile(rowClick + 1, columnClick + 2, true, true);
-			}
-
-			if (rowClick + 2 < NUM_COLS
-				&& columnClick + 1 < NUM_COLS
-				&& GetPiece(matrixColors[rowClick + 2][columnClick + 1].idPiece).color != piece.color)
-			{
-				markTile(rowClick + 2, columnClick + 1, true, true);
-			}
-
-			// Desce para o leste e sobe para o norte
-			if (rowClick + 1 < NUM_COLS
-				&& columnClick - 2 >= 0
-				&& GetPiece(matrixColors[rowClick + 1][columnClick - 2].idPiece).color != piece.color)
-			{
-				markTile(rowClick + 1, columnClick - 2, true, true);
-			}
-
-			if (rowClick + 2 < NUM_COLS
-				&& columnClick - 1 >= 0
-				&& GetPiece(matrixColors[rowClick + 2][columnClick - 1].idPiece).color != piece.color)
-			{
-				markTile(rowClick + 2, columnClick - 1, true, true);
-			}
-
-			// Desce para o leste e desce para o sul
-			if (rowClick - 1 >= 0
-				&& columnClick - 2 >= 0
-				&& GetPiece(matrixColors[rowClick - 1][columnClick - 2].idPiece).color != piece.color)
-			{
-				markTile(rowClick - 1, columnClick - 2, true, true);
-			}
-
-			if (rowClick - 2 >= 0
-				&& columnClick - 1 >= 0
-				&& GetPiece(matrixColors[rowClick - 2][columnClick - 1].idPiece).color != piece.color)
-			{
-				markTile(rowClick - 2, columnClick - 1, true, true);
-			}
-
-			// Sobe para o oeste e desce para o sul
-			if (rowClick - 1 >= 0
-				&& columnClick + 2 < NUM_COLS
-				&& GetPiece(matrixColors[rowClick - 1][columnClick + 2].idPiece).color != piece.color)
-			{
-				markTile(rowClick - 1, columnClick + 2, true, true);
-			}
-
-			if (rowClick - 2 >= 0
-				&& columnClick + 1 < NUM_COLS
-				&& GetPiece(matrixColors[rowClick - 2][columnClick + 1].idPiece).color != piece.color)
-			{
-				markTile(rowClick - 2, columnClick + 1, true, true);
-			}
-		}
-		else if (movement == Movement::Northeast)
-		{
-			int moveNortheast = NUM_COLS;
-
-			if (piece.piece == Piece::King)
-			{
-				moveNortheast = 2;
-			}
-
-			for (size_t i = 1; i < moveNortheast; i++)
-			{
-				GameObject nextTile = GetPiece(matrixColors[rowClick + i][columnClick - i].idPiece);
-
-				if (nextTile.color == piece.color)
-				{
-					break;
-				}
-
-				if (rowClick + i < NUM_ROWS && columnClick - i < NUM_ROWS)
-				{
-					markTile(rowClick + i, columnClick - i, true, true);
-				}
-
-				if (nextTile.color != piece.color && nextTile.color != NULL)
-				{
-					break;
-				}
-			}
-		}
-		else if (movement == Movement::Northwest)
-		{
-			int moveNorthwest = NUM_ROWS;
-
-			if (piece.piece == Piece::King)
-			{
-				moveNorthwest = 2;
-			}
-
-			for (size_t i = 1; i < moveNorthwest; i++)
-			{
-				GameObject nextTile = GetPiece(matrixColors[rowClick + i][columnClick + i].idPiece);
-
-				if (nextTile.color == piece.color)
-				{
-					break;
-				}
-
-				if (rowClick + i < NUM_ROWS && columnClick + i < NUM_COLS)
-				{
-					markTile(rowClick + i, columnClick + i, true, true);
-				}
-
-				if (nextTile.color != piece.color && nextTile.color != NULL)
-				{
-					break;
-				}
-			}
-		}
-		else if (movement == Movement::South)
-		{
-			int moveSouth = NUM_ROWS;
-
-			if (piece.piece == Piece::Pawn)
-			{
-				moveSouth = piece.isFirstMove ? 2 : 1;
-
-				// Regra para ataque do pio
-				if (rowClick - 1 >= 0
-					&& columnClick + 1 < NUM_COLS
-					&& matrixColors[rowClick - 1][columnClick + 1].idPiece > 0
-					&& GetPiece(matrixColors[rowClick - 1][columnClick + 1].idPiece).color != piece.color)
-				{
-					markTile(rowClick - 1, columnClick + 1, true, true);
-				}
-
-				if (rowClick - 1 >= 0
-					&& columnClick - 1 >= 0
-					&& matrixColors[rowClick - 1][columnClick - 1].idPiece > 0
-					&& GetPiece(matrixColors[rowClick - 1][columnClick - 1].idPiece).color != piece.color)
-				{
-					markTile(rowClick - 1, columnClick - 1, true, true);
-				}
-			}
-
-			if (piece.piece == Piece::King)
-			{
-				moveSouth = 1;
-			}
-
-			for (size_t i = 1; i <= moveSouth; i++)
-			{
-				if (rowClick - i < NUM_ROWS)
-				{
-					GameObject nextTile = GetPiece(matrixColors[rowClick - i][columnClick].idPiece);
-
-					if (nextTile.color == piece.color || (piece.piece == Piece::Pawn && nextTile.color != piece.color && nextTile.color != NULL))
-					{
-						break;
-					}
-
-					markTile(rowClick - i, columnClick, true, true);
-
-					if (nextTile.color != piece.color && nextTile.color != NULL)
-					{
-						break;
-					}
-				}
-			}
-		}
-		else if (movement == Movement::Southeast)
-		{
-			int moveSoutheast = rowClick;
-
-			if (piece.piece == Piece::King)
-			{
-				moveSoutheast = 1;
-			}
-
-			for (size_t i = 1; i <= moveSoutheast; i++)
-			{
-				GameObject nextTile = GetPiece(matrixColors[rowClick - i][columnClick - i].idPiece);
-
-				if (nextTile.color == piece.color)
-				{
-					break;
-				}
-
-				if (rowClick - i >= 0 && columnClick - i <= NUM_COLS)
-				{
-					markTile(rowClick - i, columnClick - i, true, true);
-				}
-
-				if (nextTile.color != piece.color && nextTile.color != NULL)
-				{
-					break;
-				}
-			}
-		}
-		else if (movement == Movement::Southwest)
-		{
-			int moveSouthwest = NUM_ROWS;
-
-			if (piece.piece == Piece::King)
-			{
-				moveSouthwest = 1;
-			}
-
-			for (size_t i = 1; i <= moveSouthwest; i++)
-			{
-				GameObject nextTile = GetPiece(matrixColors[rowClick - i][columnClick + i].idPiece);
-
-				if (nextTile.color == piece.color)
-				{
-					break;
-				}
-
-				if (rowClick - i >= 0 && columnClick + i < NUM_COLS)
-				{
-					markTile(rowClick - i, columnClick + i, true, true);
-				}
-
-				if (nextTile.color != piece.color && nextTile.color != NULL)
-				{
-					break;
-				}
-			}
-		}
-		else if (movement == Movement::West)
-		{
-			int moveWest = NUM_COLS;
-
-			if (piece.piece == Piece::King)
-			{
-				moveWest = 1;
-			}
-
-			for (size_t i = 1; i <= moveWest; i++)
-			{
-				if (columnClick + i < NUM_ROWS)
-				{
-					GameObject nextTile = GetPiece(matrixColors[rowClick][columnClick + i].idPiece);
-
-					if (nextTile.color == piece.color)
-					{
-						break;
-					}
-
-					markTile(rowClick, columnClick + i, true, true);
-
-					if (nextTile.color != piece.color && nextTile.color != NULL)
-					{
-						break;
-					}
-				}
-			}
-		}
-	}
-}
-
-int GetIndex(int id, vector<GameObject> list)
-{
-	int index = -1;
-
-	for (int i = 0; i < list.size(); i++)
-	{
-		if (list[i].id == id)
-		{
-			return i;
-		}
-	}
-
-	return index;
-}
-
-void MouseMap(double xPos, double yPos) {
-
-	int rowClick, columnClick;
-	DiamondClickCalculation(xPos, yPos, rowClick, columnClick);
-
-	if (rowClick < 0 || columnClick < 0 || columnClick >= NUM_COLS || rowClick >= NUM_ROWS)
-	{
-		return;
-	}
-
-	Tile tile = matrixColors[rowClick][columnClick];
-
-	// Verifica se for desmarcado, para poder desmarcar as possveis jogadas
-	if (matrixColors[rowClick][columnClick].canPlay)
-	{
-		GameObject& piece = GetPiece(matrixColors[lastSelectedRow][lastSelectedColumn].idPiece);
-
-		if (!tile.isSelected)
-		{
-			canPlayBlack = canPlayWhite;
-			canPlayWhite = !canPlayBlack;
-		}
-
-		matrixColors[lastSelectedRow][lastSelectedColumn].isSelected = false;
-
-		for each (pair<int, int> pos in selectedPositions)
-		{
-			markTile(pos.first, pos.second, false, false);
-		}
-
-		selectedPositions.clear();
-
-		if (matrixColors[rowClick][columnClick].idPiece != matrixColors[lastSelectedRow][lastSelectedColumn].idPiece)
-		{
-			GameObject oldPiece = GetPiece(matrixColors[rowClick][columnClick].idPiece);
-
-			someoneWin = oldPiece.piece == Piece::King;
-
-			if (matrixColors[rowClick][columnClick].idPiece > 0)
-			{
-				if (piece.color == Color::White)
-				{
-					int index = GetIndex(oldPiece.id, blackSprites);
-
-					blackSprites.erase(blackSprites.begin() + index, blackSprites.begin() + index + 1);
-				}
-				else if (piece.color == Color::Black)
-				{
-					int index = GetIndex(oldPiece.id, whiteSprites);
-
-					whiteSprites.erase(whiteSprites.begin() + index, whiteSprites.begin() + index + 1);
-				}
-			}
-
-			matrixColors[rowClick][columnClick].idPiece = matrixColors[lastSelectedRow][lastSelectedColumn].idPiece;
-			matrixColors[lastSelectedRow][lastSelectedColumn].idPiece = 0;
-
-
-			if (piece.color == Color::White)
-			{
-				int i = GetIndex(piece.id, whiteSprites);
-
-				whiteSprites[i].currentCol = columnClick;
-				whiteSprites[i].currentRow = rowClick;
-				whiteSprites[i].isFirstMove = false;
-			}
-			else
-			{
-				int i = GetIndex(piece.id, blackSprites);
-
-				blackSprites[i].currentCol = columnClick;
-				blackSprites[i].currentRow = rowClick;
-				blackSprites[i].isFirstMove = false;
-			}
-		}
-
-	}
-	else if (selectedPositions.empty() && tile.idPiece > 0) // J ter adicionado o tile selecionado, ento no estar vazio mais, apenas ter o tile selecionado
-	{
-		GameObject piece = GetPiece(matrixColors[rowClick][columnClick].idPiece);
-
-		bool playBlack = piece.color == Color::Black && canPlayBlack;
-		bool playWhite = piece.color == Color::White && canPlayWhite;
-
-		if (playBlack || playWhite)
-		{
-			lastSelectedColumn = columnClick;
-
-			lastSelectedRow = rowClick;
-
-			matrixColors[rowClick][columnClick].isSelected = true;
-
-			markTile(rowClick, columnClick, true, true);
-
-			markMovements(rowClick, columnClick, piece);
-		}
-	}
-}
-
-// Mtodo utilizado para callback de click
+// Mtodo utilizado para callback de click, a partida vem do ponteiro de usurio da janela
 void SelectPosition(GLFWwindow* window, int button, int action, int mods)
 {
 	if (action == GLFW_PRESS && button == GLFW_MOUSE_BUTTON_LEFT)
 	{
 		double xpos, ypos;
+		int rowClick, columnClick;
 
 		glfwGetCursorPos(window, &xpos, &ypos);
+		DiamondClickCalculation(xpos, ypos, rowClick, columnClick);
 
-		MouseMap(xpos, ypos);
+		static_cast<Game*>(glfwGetWindowUserPointer(window))->selectTile(rowClick, columnClick);
 	}
 }
 #pragma endregion
@@ -890,6 +176,34 @@ int main() {
 	glewExperimental = GL_TRUE;
 	glewInit();
 
+	// Tabelas de ataque das peas deslizantes (magic bitboards ou PEXT, conforme a CPU)
+	InitBitboards();
+
+	// Monta o tabuleiro e as sprites da posio inicial; o computador joga com as pretas
+	Game game;
+	game.match().setEngineSides(false, true);
+	game.match().setEngineLimits(ENGINE_LIMITS);
+	game.match().onProgress = PrintSearchInfo;
+
+	SearchThread& engine = *game.match().searchThread();
+
+	// Um ncleo fica livre para a renderizao, os outros buscam em paralelo (Lazy SMP)
+	int cores = (int)std::thread::hardware_concurrency();
+	engine.setThreads(cores > 1 ? cores - 1 : 1);
+
+	if (!engine.setHashSize(ENGINE_HASH_MB))
+	{
+		fprintf(stderr, "WARNING: could not allocate the transposition table, keeping the default size\n");
+	}
+
+	std::shared_ptr<const Nnue> network = LoadNnue(ENGINE_NNUE_FILE);
+
+	if (network)
+	{
+		engine.setNetwork(network);
+		cout << "NNUE " << ENGINE_NNUE_FILE << " (" << SimdLevelName(network->kernels().level) << ")" << endl;
+	}
+
 	const char* map_vertex_shader =
 		"#version 410\n"
 		"layout(location = 0) in vec2 aPos;"
@@ -936,10 +250,8 @@ int main() {
 		" frag_color = texel;"
 		"}";
 
-	CreateMatrixColors();
-	ConfigSprites();
-
 	glm::mat4 proj = glm::ortho(0.0f, (float)WIDTH, (float)HEIGHT, 0.0f, -1.0f, 1.0f);
+	glm::mat4 matrix = glm::mat4(1);
 
 	int mapShader_programme = ConnectVertex(map_vertex_shader, map_fragment_shader);
 	int textureShader_programme = ConnectVertex(textureVertex_shader, textureFragment_shader);
@@ -1007,9 +319,10 @@ int main() {
 	glEnableVertexAttribArray(1);
 
 	// esta para quando clicar com o mouse
+	glfwSetWindowUserPointer(window, &game);
 	glfwSetMouseButtonCallback(window, SelectPosition);
 
-	while (!glfwWindowShouldClose(window) && !someoneWin)
+	while (!glfwWindowShouldClose(window) && !game.match().isOver())
 	{
 		glfwPollEvents();
 
@@ -1039,14 +352,16 @@ int main() {
 		unsigned int transformloc = glGetUniformLocation(textureShader_programme, "matrix");
 		glUniformMatrix4fv(transformloc, 1, GL_FALSE, glm::value_ptr(matrix));
 
-		for each (GameObject bs in blackSprites)
+		// Desenha uma sprite em cada casa ocupada
+		for (Bitboard occupied = game.match().board().occupied(); occupied; )
 		{
-			DefineOffsetAndRender(textureShader_programme, 0.0f, 0.0f, 0.51f, matrix, bs, transformloc);
-		}
+			int sq = PopLsb(occupied);
+			int row = RowOf(sq), col = ColOf(sq);
 
-		for each (GameObject ws in whiteSprites)
-		{
-			DefineOffsetAndRender(textureShader_programme, 0.0f, 0.0f, 0.51f, matrix, ws, transformloc);
+			if (game.pieces().contains(game.tile(row, col).idPiece))
+			{
+				DefineOffsetAndRender(textureShader_programme, 0.0f, 0.0f, 0.51f, matrix, game.pieces().get(game.tile(row, col).idPiece), row, col, transformloc);
+			}
 		}
 
 		// Desenha o diamond
@@ -1057,9 +372,11 @@ int main() {
 		//Define VAO atual
 		glBindVertexArray(mapVAO);
 
-		RenderDiamondMap(matrix, mapShader_programme);
+		RenderDiamondMap(game, matrix, mapShader_programme);
 
 		glfwSwapBuffers(window);
+
+		game.updateEngine();
 	}
 
 	// encerra contexto GL e outros recursos da GLFW
@@ -0,0 +1,520 @@
+#include "Uci.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "MoveList.h"
+#include "Nnue.h"
+#include "NnueKernels.h"
+
+using namespace std;
+
+namespace
+{
+	const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+	const char* DEFAULT_NNUE_FILE = "sabertooth.nnue";
+
+	const int MAX_THREADS = 256;
+	const size_t MAX_HASH_MB = 32768;
+	// How often the command loop looks at the search when no input arrives
+	const int POLL_INTERVAL_MS = 5;
+	// Time kept back on every move for the GUI and the pipe
+	const int64_t MOVE_OVERHEAD = 30;
+	// Moves the remaining time is split over when the time control does not say
+	const int MOVES_LEFT = 30;
+
+	// Share of the clock for one move: an even split over the moves to go plus most of the increment
+	int64_t MoveTime(int64_t time, int64_t increment, int movesToGo)
+	{
+		int64_t budget = time / (movesToGo > 0 ? movesToGo : MOVES_LEFT) + increment * 3 / 4;
+		int64_t maximum = time - MOVE_OVERHEAD;
+
+		if (budget > maximum)
+		{
+			budget = maximum;
+		}
+
+		// Zero would mean no limit at all
+		return budget > 1 ? budget : 1;
+	}
+
+	string ScoreToString(int score)
+	{
+		if (score > VALUE_MATE_IN_MAX_PLY)
+		{
+			return "mate " + to_string((VALUE_MATE - score + 1) / 2);
+		}
+
+		if (score < -VALUE_MATE_IN_MAX_PLY)
+		{
+			return "mate " + to_string(-(VALUE_MATE + score) / 2);
+		}
+
+		return "cp " + to_string(score);
+	}
+
+	// The rest of the stream, words separated by single spaces
+	string Remaining(istringstream& args)
+	{
+		string word;
+		string text;
+
+		while (args >> word)
+		{
+			text += text.empty() ? "" : " ";
+			text += word;
+		}
+
+		return text;
+	}
+}
+
+InputQueue::InputQueue() : shared(make_shared<Shared>())
+{
+	shared_ptr<Shared> queue = shared;
+
+	thread([queue]()
+	{
+		string line;
+
+		while (getline(cin, line))
+		{
+			lock_guard<mutex> lock(queue->mutex);
+			queue->lines.push_back(line);
+			queue->ready.notify_one();
+		}
+
+		lock_guard<mutex> lock(queue->mutex);
+		queue->eof = true;
+		queue->ready.notify_one();
+	}).detach();
+}
+
+bool InputQueue::next(string& line, int timeoutMs)
+{
+	unique_lock<mutex> lock(shared->mutex);
+
+	shared->ready.wait_for(lock, chrono::milliseconds(timeoutMs), [this]() { return !shared->lines.empty() || shared->eof; });
+
+	if (shared->lines.empty())
+	{
+		return false;
+	}
+
+	line = shared->lines.front();
+	shared->lines.pop_front();
+
+	return true;
+}
+
+bool InputQueue::ended() const
+{
+	lock_guard<mutex> lock(shared->mutex);
+	return shared->eof && shared->lines.empty();
+}
+
+UciEngine::UciEngine() : lastResult(), lastIteration(), searching(false), infinite(false), stopRequested(false), resultPending(false),
+	sentDepth(0)
+{
+	position.setStartPosition();
+
+	// Same default as the graphical game: the network next to the executable, if there is one
+	engine.setNetwork(LoadNnue(DEFAULT_NNUE_FILE));
+}
+
+void UciEngine::loop()
+{
+	string line;
+
+	while (true)
+	{
+		if (input.next(line, POLL_INTERVAL_MS))
+		{
+			if (!execute(line))
+			{
+				break;
+			}
+		}
+		else if (input.ended())
+		{
+			// End of input is a quit that still lets the running search send its move
+			if (infinite)
+			{
+				stop();
+			}
+
+			if (!searching)
+			{
+				break;
+			}
+		}
+
+		update();
+	}
+
+	engine.stop();
+}
+
+bool UciEngine::execute(const string& line)
+{
+	istringstream args(line);
+	string command;
+
+	if (!(args >> command))
+	{
+		return true;
+	}
+
+	if (command == "quit")
+	{
+		return false;
+	}
+	else if (command == "uci")
+	{
+		uci();
+	}
+	else if (command == "isready")
+	{
+		cout << "readyok" << endl;
+	}
+	else if (command == "ucinewgame")
+	{
+		engine.clearHash();
+	}
+	else if (command == "setoption")
+	{
+		setOption(args);
+	}
+	else if (command == "position")
+	{
+		setPosition(args);
+	}
+	else if (command == "go")
+	{
+		go(args);
+	}
+	else if (command == "stop")
+	{
+		stop();
+	}
+	else if (command == "stats")
+	{
+		// Not part of the protocol: every counter of the running search, or of the last one when idle,
+		// for tuning from a terminal
+		SearchResult result = lastResult;
+
+		if (searching)
+		{
+			result = lastIteration;
+			engine.readCounters(result);
+		}
+		else if (lastResult.nodes == 0)
+		{
+			cout << "info string no search yet" << endl;
+			return true;
+		}
+
+		istringstream report(StatsReport(result));
+		string reportLine;
+
+		while (getline(report, reportLine))
+		{
+			cout << "info string " << reportLine << endl;
+		}
+	}
+	else
+	{
+		cout << "info string unknown command " << command << endl;
+	}
+
+	return true;
+}
+
+void UciEngine::uci()
+{
+	cout << "id name Sabertooth" << endl;
+	cout << "id author Rafael de Freitas" << endl;
+	cout << "option name Hash type spin default " << (size_t)TranspositionTable::DEFAULT_SIZE_MB << " min 1 max " << MAX_HASH_MB << endl;
+	cout << "option name Threads type spin default 1 min 1 max " << MAX_THREADS << endl;
+	cout << "option name EvalFile type string default " << DEFAULT_NNUE_FILE << endl;
+	cout << "option name Clear Hash type button" << endl;
+	cout << "uciok" << endl;
+}
+
+// setoption name <id> [value <x>], where both may contain spaces
+void UciEngine::setOption(istringstream& args)
+{
+	string word;
+	string name;
+
+	args >> word;
+
+	while (args >> word && word != "value")
+	{
+		name += name.empty() ? "" : " ";
+		name += word;
+	}
+
+	string value = Remaining(args);
+
+	if (name == "Hash")
+	{
+		long long megabytes = atoll(value.c_str());
+
+		if (megabytes < 1 || (size_t)megabytes > MAX_HASH_MB || !engine.setHashSize((size_t)megabytes))
+		{
+			cout << "info string could not allocate " << value << " MB of hash" << endl;
+		}
+	}
+	else if (name == "Threads")
+	{
+		int threads = atoi(value.c_str());
+		engine.setThreads(threads < 1 ? 1 : threads > MAX_THREADS ? MAX_THREADS : threads);
+	}
+	else if (name == "EvalFile")
+	{
+		// Setting the network waits for the search to end
+		if (searching)
+		{
+			cout << "info string the network cannot change during a search" << endl;
+		}
+		else if (value.empty() || value == "<empty>")
+		{
+			engine.setNetwork(nullptr);
+			cout << "info string classical evaluation" << endl;
+		}
+		else if (shared_ptr<const Nnue> network = LoadNnue(value))
+		{
+			engine.setNetwork(network);
+			cout << "info string NNUE " << value << " (" << SimdLevelName(network->kernels().level) << ")" << endl;
+		}
+		else
+		{
+			cout << "info string could not load " << value << endl;
+		}
+	}
+	else if (name == "Clear Hash")
+	{
+		engine.clearHash();
+	}
+	else
+	{
+		cout << "info string unknown option " << name << endl;
+	}
+}
+
+// position startpos | fen <fen> [moves <move> ...]
+void UciEngine::setPosition(istringstream& args)
+{
+	string word;
+	string fen;
+
+	args >> word;
+
+	if (word == "startpos")
+	{
+		fen = START_FEN;
+		args >> word;
+	}
+	else if (word == "fen")
+	{
+		while (args >> word && word != "moves")
+		{
+			fen += fen.empty() ? "" : " ";
+			fen += word;
+		}
+	}
+
+	if (!position.setFen(fen))
+	{
+		cout << "info string invalid position " << fen << endl;
+		position.setStartPosition();
+		return;
+	}
+
+	if (word != "moves")
+	{
+		return;
+	}
+
+	while (args >> word)
+	{
+		MoveList legal(position);
+		Move move = NO_MOVE;
+
+		for (Move candidate : legal)
+		{
+			if (MoveToString(candidate) == word)
+			{
+				move = candidate;
+				break;
+			}
+		}
+
+		if (move == NO_MOVE)
+		{
+			cout << "info string illegal move " << word << endl;
+			return;
+		}
+
+		position.make(move);
+	}
+}
+
+void UciEngine::go(istringstream& args)
+{
+	SearchLimits limits = {};
+	int64_t time[NUM_COLORS] = {};
+	int64_t increment[NUM_COLORS] = {};
+	int movesToGo = 0;
+	string word;
+
+	// The GUI should have stopped the previous search; its move is still owed
+	stop();
+	infinite = false;
+
+	while (args >> word)
+	{
+		if (word == "depth")
+		{
+			args >> limits.depth;
+		}
+		else if (word == "nodes")
+		{
+			args >> limits.nodes;
+		}
+		else if (word == "movetime")
+		{
+			args >> limits.moveTime;
+		}
+		else if (word == "wtime")
+		{
+			args >> time[Color::White];
+		}
+		else if (word == "btime")
+		{
+			args >> time[Color::Black];
+		}
+		else if (word == "winc")
+		{
+			args >> increment[Color::White];
+		}
+		else if (word == "binc")
+		{
+			args >> increment[Color::Black];
+		}
+		else if (word == "movestogo")
+		{
+			args >> movesToGo;
+		}
+		else if (word == "infinite")
+		{
+			infinite = true;
+		}
+	}
+
+	Color us = position.sideToMove();
+
+	if (!infinite && limits.moveTime == 0 && time[us] > 0)
+	{
+		limits.moveTime = MoveTime(time[us], increment[us], movesToGo);
+	}
+
+	engine.start(position, limits);
+	searching = true;
+	sentDepth = 0;
+	lastIteration = SearchResult();
+	stopRequested = false;
+	resultPending = false;
+}
+
+void UciEngine::stop()
+{
+	if (searching)
+	{
+		// Waits for the move, so that a go right behind the stop cannot drop it
+		stopRequested = true;
+		engine.stop();
+
+		while (searching)
+		{
+			this_thread::sleep_for(chrono::milliseconds(1));
+			update();
+		}
+	}
+	else if (resultPending)
+	{
+		resultPending = false;
+		sendBestMove(lastResult);
+	}
+}
+
+void UciEngine::update()
+{
+	SearchInfo info;
+
+	if (!searching || !engine.poll(info))
+	{
+		return;
+	}
+
+	lastIteration = info.result;
+
+	// The finished result repeats the last iteration unless the search ended before completing one
+	if (!info.finished || info.result.depth != sentDepth)
+	{
+		sendInfo(info.result);
+	}
+
+	if (!info.finished)
+	{
+		return;
+	}
+
+	searching = false;
+	lastResult = info.result;
+
+	if (infinite && !stopRequested)
+	{
+		resultPending = true;
+	}
+	else
+	{
+		sendBestMove(lastResult);
+	}
+}
+
+void UciEngine::sendInfo(const SearchResult& result)
+{
+	if (result.depth == 0)
+	{
+		return;
+	}
+
+	int64_t elapsed = result.elapsed > 0 ? result.elapsed : 1;
+
+	sentDepth = result.depth;
+
+	cout << "info depth " << result.depth << " score " << ScoreToString(result.score)
+		<< " nodes " << result.nodes << " nps " << result.nodes * 1000 / elapsed
+		<< " hashfull " << result.hashfull << " time " << result.elapsed << " pv";
+
+	for (int i = 0; i < result.pvLength; i++)
+	{
+		cout << " " << MoveToString(result.pv[i]);
+	}
+
+	cout << endl;
+
+	// Hit and cutoff rates summed over the threads so far, as the graphical game prints them, and
+	// the time of this iteration alone
+	cout << "info string depth " << result.depth << " iteration " << result.stats.iterationTime[result.depth]
+		<< "ms " << StatsSummary(result) << endl;
+}
+
+void UciEngine::sendBestMove(const SearchResult& result)
+{
+	cout << "bestmove " << (result.bestMove != NO_MOVE ? MoveToString(result.bestMove) : "0000") << endl;
+}
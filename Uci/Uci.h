@@ -0,0 +1,77 @@
+#ifndef UCI_H
+#define UCI_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include "Position.h"
+#include "SearchThread.h"
+
+// Lines of standard input, read by a thread of their own so the engine can keep answering while
+// a search runs. The consumer only ever waits with a timeout. The reader may be blocked on stdin
+// when the engine quits, so it is detached and shares the queue with its owner.
+class InputQueue
+{
+public:
+	InputQueue();
+
+	// Waits up to timeoutMs for a line. Returns false on timeout and once input has ended.
+	bool next(std::string& line, int timeoutMs);
+	// True after the last line was taken and stdin reached end of file
+	bool ended() const;
+
+private:
+	struct Shared
+	{
+		std::mutex mutex;
+		std::condition_variable ready;
+		std::deque<std::string> lines;
+		bool eof = false;
+	};
+
+	std::shared_ptr<Shared> shared;
+};
+
+// Universal Chess Interface on stdin and stdout. The search runs on a SearchThread, so commands
+// such as stop, isready and quit are answered while it thinks.
+class UciEngine
+{
+public:
+	UciEngine();
+
+	// Reads and runs commands until quit or the end of input
+	void loop();
+
+private:
+	// Returns false on quit
+	bool execute(const std::string& line);
+	void uci();
+	void setOption(std::istringstream& args);
+	void setPosition(std::istringstream& args);
+	void go(std::istringstream& args);
+	void stop();
+	// Forwards the progress of the search and sends bestmove once it is done
+	void update();
+	void sendInfo(const SearchResult& result);
+	void sendBestMove(const SearchResult& result);
+
+	SearchThread engine;
+	InputQueue input;
+	Position position;
+	SearchResult lastResult;
+	// Latest progress of the running search; the stats command adds the live counters to it
+	SearchResult lastIteration;
+	bool searching;
+	// go infinite: the best move may only be sent after stop, even if the search ends first
+	bool infinite;
+	bool stopRequested;
+	bool resultPending;
+	// Depth of the last info line of the running search, 0 before the first
+	int sentDepth;
+};
+
+#endif
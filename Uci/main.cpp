@@ -0,0 +1,12 @@
+#include "Bitboard.h"
+#include "Uci.h"
+
+int main()
+{
+	InitBitboards();
+
+	UciEngine uci;
+	uci.loop();
+
+	return 0;
+}